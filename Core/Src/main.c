@@ -18,6 +18,7 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "dma.h"
 #include "tim.h"
 #include "usart.h"
 #include "gpio.h"
@@ -102,6 +103,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART1_UART_Init();
   MX_USART2_UART_Init();
   MX_TIM2_Init();
@@ -113,15 +115,18 @@ int main(void)
       "*** DataLink Host ****\r\n"
       "***    V " APP_VERSION_STR "    ****\r\n"
       "**********************\r\n\r\n";
-  HAL_UART_Transmit(&huart2, (uint8_t*)cls, (uint16_t)strlen((const char*)cls), 50);
+  print_bytes(cls, (uint16_t)strlen((const char*)cls));
 
   // Start timer interrupt for LED heartbeat
   HAL_TIM_Base_Start_IT(&htim2);
 
   HAL_Delay(1000);
 
-  // Build CRC16 LUT once (Ocean UI polynomial)
-  crc16_init();  /* LUT based on poly 0xA2EB, init value 0xFFFF */ /*cite*/
+  // CRC16 LUT (Ocean UI polynomial) is a const table in flash; kept for compatibility
+  crc16_init();  /* no-op: poly 0xA2EB, init value 0xFFFF */
+
+  // Start circular DMA reception (idle-line framed) on the DataLink UART (USART1)
+  dl_rx_start();
 
   // Wait until contact i.e loop here until contact with Ocean Driver
   while(!dl_handshake())
@@ -149,6 +154,8 @@ int main(void)
 
   while (1)
   {
+	  (void)dl_poll();  /* service queued asynchronous DataLink transactions */
+
 //	    uint32_t now = HAL_GetTick();
 //
 //	    /* If config wasn't loaded (e.g., handshake recovery), try again */
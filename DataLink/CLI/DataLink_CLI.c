@@ -5,17 +5,17 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include "main.h"   /* HAL_GetTick, HAL_Delay */
-#include "usart.h"  /* extern UART_HandleTypeDef huart2 (console) */
+#include "usart.h"  /* extern UART_HandleTypeDef huart2 (console input) */
+#include "DataLink_HAL.h"   /* print_bytes: queued, interrupt-driven console output */
 #include "DataLink_User.h" /* mid-level functions: SetPower, ReadOutputState, etc. */
+#include "DataLink_Driver.h" /* dl_poll: keep async DataLink work moving while idle; link counters */
+#include "DataLink_Trace.h"  /* TRACE DUMP: binary frame capture of the DataLink */
 
 /* ================================
  * UART console configuration
  * ================================ */
-#ifndef CLI_UART_TX_TIMEOUT_MS
-#define CLI_UART_TX_TIMEOUT_MS 100U
-#endif
-#ifndef CLI_UART_RX_TIMEOUT_MS
-#define CLI_UART_RX_TIMEOUT_MS HAL_MAX_DELAY
+#ifndef CLI_UART_RX_POLL_MS
+#define CLI_UART_RX_POLL_MS 5U      /* console wait slice; dl_poll() runs between slices */
 #endif
 #ifndef CLI_MAX_LINE
 #define CLI_MAX_LINE 100U
@@ -118,6 +118,7 @@ void CLI_PrintHelp(void)
         "Commands:\r\n"
         " CONFIG CHANNEL <1 - 4>\r\n"
         " CONFIG POWER <0.5 - 1.0>\r\n"
+        " CONFIG ALL <1 - 4> <0.5 - 1.0>\r\n"
         " READ CONFIG\r\n"
         " READ DATA\r\n"
         " READ ERRORS\r\n"
@@ -126,10 +127,13 @@ void CLI_PrintHelp(void)
         " READ OUTPUT\r\n"
         " SET DEFAULT <0|1>\r\n"
         " READ DEFAULT\r\n"
+        " STATS\r\n"
+        " STATS RESET\r\n"
+        " TRACE DUMP\r\n"
         " HELP\r\n"
         " X | EXIT\r\n";
 
-    (void)HAL_UART_Transmit(&huart2, (uint8_t*)help, (uint16_t)(sizeof(help) - 1U), CLI_UART_TX_TIMEOUT_MS);
+    print_bytes(help, (uint16_t)(sizeof(help) - 1U));
 }
 
 /* ================================
@@ -151,8 +155,14 @@ bool CLI_ReadLine(char *buf, uint16_t cap)
     while(1)
     {
         uint8_t ch = 0U;
+        HAL_StatusTypeDef hs = HAL_UART_Receive(&huart2, &ch, 1U, CLI_UART_RX_POLL_MS);
 
-        if (HAL_UART_Receive(&huart2, &ch, 1U, CLI_UART_RX_TIMEOUT_MS) != HAL_OK)
+        if (hs == HAL_TIMEOUT)
+        {
+            (void)dl_poll();
+            continue;
+        }
+        if (hs != HAL_OK)
         {
             return false;
         }
@@ -160,7 +170,7 @@ bool CLI_ReadLine(char *buf, uint16_t cap)
         if ((ch == '\r') || (ch == '\n'))
         {
             static const char crlf[] = "\r\n";
-            (void)HAL_UART_Transmit(&huart2, (uint8_t*)crlf, 2U, CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(crlf, 2U);
             buf[idx] = '\0';
             return true;
         }
@@ -172,7 +182,7 @@ bool CLI_ReadLine(char *buf, uint16_t cap)
                 static const char bs_erase[] = "\b \b";
                 idx--;
                 buf[idx] = '\0';
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)bs_erase, (uint16_t)(sizeof(bs_erase) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(bs_erase, (uint16_t)(sizeof(bs_erase) - 1U));
             }
             continue;
         }
@@ -181,12 +191,12 @@ bool CLI_ReadLine(char *buf, uint16_t cap)
         {
             buf[idx] = (char)ch;
             idx++;
-            (void)HAL_UART_Transmit(&huart2, &ch, 1U, CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(&ch, 1U);
         }
         else
         {
             static const char trunc_msg[] = "\r\n(line truncated)\r\n";
-            (void)HAL_UART_Transmit(&huart2, (uint8_t*)trunc_msg, (uint16_t)(sizeof(trunc_msg) - 1U), CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(trunc_msg, (uint16_t)(sizeof(trunc_msg) - 1U));
         }
     }
 }
@@ -308,6 +318,14 @@ bool CLI_Parse(const char *line_in, cli_command_t *out)
     {
         out->primary = CMD_HELP;
     }
+    else if (strcmp(tok[0], "STATS") == 0)
+    {
+        out->primary = CMD_STATS;
+    }
+    else if (strcmp(tok[0], "TRACE") == 0)
+    {
+        out->primary = CMD_TRACE;
+    }
     else if ((strcmp(tok[0], "EXIT") == 0) || (strcmp(tok[0], "X") == 0))
     {
         out->primary = CMD_EXIT;
@@ -365,6 +383,26 @@ bool CLI_Parse(const char *line_in, cli_command_t *out)
                 out->has_float = true;
                 out->fval      = f;
             }
+            else if (strcmp(tok[1], "ALL") == 0)
+            {
+                out->secondary = SUB_ALL;
+                if (ntok != 4)
+                {
+                    return false;
+                }
+                if ((parse_int(tok[2], &v) == false) || (parse_float(tok[3], &f) == false))
+                {
+                    return false;
+                }
+                if ((v < 1) || (v > 4) || (f < 0.5f) || (f > 1.0f))
+                {
+                    return false;
+                }
+                out->has_int   = true;
+                out->ival      = v;
+                out->has_float = true;
+                out->fval      = f;
+            }
             else
             {
                 return false;
@@ -460,6 +498,33 @@ bool CLI_Parse(const char *line_in, cli_command_t *out)
         }
         break;
 
+        case CMD_STATS:
+        {
+            if (ntok == 1)
+            {
+                out->secondary = SUB_NONE;
+            }
+            else if ((ntok == 2) && (strcmp(tok[1], "RESET") == 0))
+            {
+                out->secondary = SUB_RESET;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        break;
+
+        case CMD_TRACE:
+        {
+            if ((ntok != 2) || (strcmp(tok[1], "DUMP") != 0))
+            {
+                return false;
+            }
+            out->secondary = SUB_DUMP;
+        }
+        break;
+
         case CMD_HELP:
         case CMD_EXIT:
         {
@@ -514,6 +579,24 @@ void CLI_Execute(const cli_command_t *cmd, cli_result_t *res)
         }
         return;
 
+        case CMD_STATS:
+        {
+            /* Plain STATS only reads the counters; the presenter takes the snapshot */
+            if (cmd->secondary == SUB_RESET)
+            {
+                dl_reset_counters();
+            }
+            res->code = CLI_RES_OK;
+        }
+        return;
+
+        case CMD_TRACE:
+        {
+            /* Streaming is output only; the presenter does it */
+            res->code = CLI_RES_OK;
+        }
+        return;
+
         case CMD_CONFIG:
         {
             if ((cmd->secondary == SUB_CHANNEL) && (cmd->has_int == true))
@@ -542,6 +625,19 @@ void CLI_Execute(const cli_command_t *cmd, cli_result_t *res)
                 }
                 return;
             }
+            else if ((cmd->secondary == SUB_ALL) && (cmd->has_int == true) && (cmd->has_float == true))
+            {
+                ok = SetConfig((uint8_t)cmd->ival, cmd->fval);
+                if (ok == true)
+                {
+                    res->code = CLI_RES_OK;
+                }
+                else
+                {
+                    res->code = CLI_RES_LINK_ERR;
+                }
+                return;
+            }
             else
             {
                 res->code = CLI_RES_BAD_ARGS;
@@ -557,20 +653,12 @@ void CLI_Execute(const cli_command_t *cmd, cli_result_t *res)
                 u8_val  = 0U;
                 f32_val = 0.0f;
 
-                ok = ReadChannels(&u8_val);
+                ok = ReadConfig(&u8_val, &f32_val);
                 if (ok == true)
                 {
-                    ok = ReadPower(&f32_val);
-                    if (ok == true)
-                    {
-                        res->u8   = u8_val;
-                        res->f32  = f32_val;
-                        res->code = CLI_RES_OK;
-                    }
-                    else
-                    {
-                        res->code = CLI_RES_LINK_ERR;
-                    }
+                    res->u8   = u8_val;
+                    res->f32  = f32_val;
+                    res->code = CLI_RES_OK;
                 }
                 else
                 {
@@ -684,7 +772,7 @@ void CLI_Execute(const cli_command_t *cmd, cli_result_t *res)
                     res->u8   = u8_val;
                     res->code = CLI_RES_OK;
                     static const char ok[] = "OK\r\n";
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
                 }
                 else
                 {
@@ -709,7 +797,7 @@ void CLI_Execute(const cli_command_t *cmd, cli_result_t *res)
                     res->u8   = u8_val;
                     res->code = CLI_RES_OK;
                     static const char ok[] = "OK\r\n";
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
                 }
                 else
                 {
@@ -778,7 +866,96 @@ static void print_error(cli_result_code_t code)
         /* default already set */
     }
 
-    (void)HAL_UART_Transmit(&huart2, (uint8_t*)msg, (uint16_t)strlen(msg), CLI_UART_TX_TIMEOUT_MS);
+    print_bytes(msg, (uint16_t)strlen(msg));
+}
+
+static void print_text(const char *line, int n, size_t cap)
+{
+    if (n > 0)
+    {
+        if ((size_t)n >= cap)
+        {
+            n = (int)cap - 1;   /* snprintf truncated */
+        }
+        print_bytes(line, (uint16_t)n);
+    }
+}
+
+/* One histogram row: "<label>: <lower bound ms>:<count> ..." for every non-empty bucket.
+   Sized for all buckets at their largest count, so the row is never cut. */
+static void print_histogram(const char *label, const uint32_t *hist)
+{
+    char line[16U + (DL_HIST_BUCKETS * 18U)];
+    int  n;
+    int  k;
+
+    n = snprintf(line, sizeof(line), "%s:", label);
+    for (uint8_t b = 0U; (b < DL_HIST_BUCKETS) && (n > 0) && (n < (int)sizeof(line)); b++)
+    {
+        if (hist[b] == 0UL)
+        {
+            continue;
+        }
+        k = snprintf(&line[n], sizeof(line) - (size_t)n, " %lu%s:%lu", (unsigned long)dl_hist_bucket_ms(b),
+                     (b == (DL_HIST_BUCKETS - 1U)) ? "+" : "", (unsigned long)hist[b]);
+        if (k < 0)
+        {
+            break;
+        }
+        n += k;
+    }
+    if ((n > 0) && (n < ((int)sizeof(line) - 2)))
+    {
+        line[n++] = '\r';
+        line[n++] = '\n';
+    }
+    print_text(line, n, sizeof(line));
+}
+
+/* dl_trace_dump sink: the binary stream goes out on the console UART as is. */
+static void trace_write(const uint8_t *p, uint16_t n, void *ctx)
+{
+    (void)ctx;
+    print_bytes(p, n);
+}
+
+/* TRACE DUMP: a text line, the binary dump (decode with Tools/dl_trace), then CRLF. */
+static void print_trace(void)
+{
+    char line[48];
+    int  n;
+    static const char crlf[] = "\r\n";
+
+    n = snprintf(line, sizeof(line), "TRACE: %u entries\r\n", (unsigned)dl_trace_count());
+    print_text(line, n, sizeof(line));
+    dl_trace_dump(dl_now_us(), trace_write, NULL);
+    print_bytes(crlf, 2U);
+}
+
+/* Counters and latency histograms of the default link (STATS). */
+static void print_stats(void)
+{
+    dl_link_counters_t c;
+    char               line[160];
+    int                n;
+
+    dl_get_counters(&c);
+
+    n = snprintf(line, sizeof(line), "FRAMES: tx %lu rx %lu\r\nBYTES: tx %lu rx %lu\r\n",
+                 (unsigned long)c.tx_frames, (unsigned long)c.rx_frames,
+                 (unsigned long)c.tx_bytes, (unsigned long)c.rx_bytes);
+    print_text(line, n, sizeof(line));
+    n = snprintf(line, sizeof(line), "CRC_FAIL: %lu\r\nTIMEOUTS: hdr %lu payload %lu\r\nINVALID: %lu\r\nOVERRUNS: %lu\r\n",
+                 (unsigned long)c.crc_fail, (unsigned long)c.hdr_timeouts,
+                 (unsigned long)c.pay_timeouts, (unsigned long)c.invalid, (unsigned long)c.overruns);
+    print_text(line, n, sizeof(line));
+    n = snprintf(line, sizeof(line), "RETRIES: %lu\r\nRESYNC_BYTES: %lu\r\nHANDSHAKES: full %lu quick %lu failed %lu\r\n",
+                 (unsigned long)c.retries, (unsigned long)c.resync_bytes, (unsigned long)c.full_handshakes,
+                 (unsigned long)c.quick_handshakes, (unsigned long)c.handshake_fail);
+    print_text(line, n, sizeof(line));
+
+    print_histogram("READ_MS", c.hist[0]);
+    print_histogram("WRITE_MS", c.hist[1]);
 }
 
 void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
@@ -800,7 +977,7 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
     if (cmd->primary == CMD_EXIT)
     {
         static const char ok[] = "OK\r\n";
-        (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+        print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
         return;
     }
 
@@ -815,7 +992,7 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
         case CMD_CONFIG:
         {
             static const char ok[] = "OK\r\n";
-            (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
         }
         break;
 
@@ -828,7 +1005,7 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
                     n = snprintf(line, sizeof(line), "CHANNELS: %u\r\n", (unsigned)res->u8);
                     if (n > 0)
                     {
-                        (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                        print_bytes(line, (uint16_t)n);
                     }
                 }
                 if (res->f32 > 0.0f)
@@ -836,23 +1013,23 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
                     n = snprintf(line, sizeof(line), "POWER: %.3f\r\n", (double)res->f32);
                     if (n > 0)
                     {
-                        (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                        print_bytes(line, (uint16_t)n);
                     }
                 }
                 static const char ok[] = "OK\r\n";
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
             }
             else if (cmd->secondary == SUB_DATA)
             {
                 static const char ok[] = "OK\r\n";
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
             }
             else if (cmd->secondary == SUB_ERRORS)
             {
                 n = snprintf(line, sizeof(line), "ERRORS: 0x%08lX\r\nOK\r\n", (unsigned long)res->u32);
                 if (n > 0)
                 {
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(line, (uint16_t)n);
                 }
             }
             else if (cmd->secondary == SUB_OUTPUT)
@@ -860,7 +1037,7 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
                 n = snprintf(line, sizeof(line), "OUTPUT: %u\r\nOK\r\n", (unsigned)res->u8);
                 if (n > 0)
                 {
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(line, (uint16_t)n);
                 }
             }
             else if (cmd->secondary == SUB_DEFAULT)
@@ -868,13 +1045,13 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
                 n = snprintf(line, sizeof(line), "DEFAULT: %u\r\nOK\r\n", (unsigned)res->u8);
                 if (n > 0)
                 {
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(line, (uint16_t)n);
                 }
             }
             else
             {
                 static const char ok[] = "OK\r\n";
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
             }
         }
         break;
@@ -882,7 +1059,26 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
         case CMD_RESET:
         {
             static const char ok[] = "OK\r\n";
-            (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
+        }
+        break;
+
+        case CMD_TRACE:
+        {
+            static const char ok[] = "OK\r\n";
+            print_trace();
+            print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
+        }
+        break;
+
+        case CMD_STATS:
+        {
+            static const char ok[] = "OK\r\n";
+            if (cmd->secondary != SUB_RESET)
+            {
+                print_stats();
+            }
+            print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
         }
         break;
 
@@ -893,7 +1089,7 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
                 n = snprintf(line, sizeof(line), "OUTPUT:= %u\r\nOK\r\n", (unsigned)res->u8);
                 if (n > 0)
                 {
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(line, (uint16_t)n);
                 }
             }
             else if (cmd->secondary == SUB_DEFAULT)
@@ -901,13 +1097,13 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
                 n = snprintf(line, sizeof(line), "DEFAULT:= %u\r\nOK\r\n", (unsigned)res->u8);
                 if (n > 0)
                 {
-                    (void)HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, CLI_UART_TX_TIMEOUT_MS);
+                    print_bytes(line, (uint16_t)n);
                 }
             }
             else
             {
                 static const char ok[] = "OK\r\n";
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
             }
         }
         break;
@@ -915,7 +1111,7 @@ void CLI_PrintResult(const cli_command_t *cmd, const cli_result_t *res)
         default:
         {
             static const char ok[] = "OK\r\n";
-            (void)HAL_UART_Transmit(&huart2, (uint8_t*)ok, (uint16_t)(sizeof(ok) - 1U), CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(ok, (uint16_t)(sizeof(ok) - 1U));
         }
         break;
     }
@@ -931,13 +1127,13 @@ bool ManualMode(void)
         "\r\n*** DataLink CLI ***\r\n"
         "Type HELP for commands, X to exit.\r\n\r\n";
 
-    (void)HAL_UART_Transmit(&huart2, (uint8_t*)banner, (uint16_t)(sizeof(banner) - 1U), CLI_UART_TX_TIMEOUT_MS);
+    print_bytes(banner, (uint16_t)(sizeof(banner) - 1U));
 
     while(1)
     {
         static const char prompt[] = "> ";
 
-        (void)HAL_UART_Transmit(&huart2, (uint8_t*)prompt, (uint16_t)(sizeof(prompt) - 1U), CLI_UART_TX_TIMEOUT_MS);
+        print_bytes(prompt, (uint16_t)(sizeof(prompt) - 1U));
 
         if (CLI_ReadLine(line, (uint16_t)sizeof(line)) == false)
         {
@@ -950,7 +1146,7 @@ bool ManualMode(void)
         if ((strcmp(line, "X") == 0) || (strcmp(line, "EXIT") == 0))
         {
             static const char bye[] = "Bye.\r\n";
-            (void)HAL_UART_Transmit(&huart2, (uint8_t*)bye, (uint16_t)(sizeof(bye) - 1U), CLI_UART_TX_TIMEOUT_MS);
+            print_bytes(bye, (uint16_t)(sizeof(bye) - 1U));
             return true;
         }
 
@@ -966,7 +1162,7 @@ bool ManualMode(void)
             if (CLI_Parse(line, &cmd) == false)
             {
                 static const char err[] = "ERR SYNTAX\r\n";
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)err, (uint16_t)(sizeof(err) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(err, (uint16_t)(sizeof(err) - 1U));
                 continue;
             }
 
@@ -979,7 +1175,7 @@ bool ManualMode(void)
             if (cmd.primary == CMD_EXIT)
             {
                 static const char bye2[] = "Bye.\r\n";
-                (void)HAL_UART_Transmit(&huart2, (uint8_t*)bye2, (uint16_t)(sizeof(bye2) - 1U), CLI_UART_TX_TIMEOUT_MS);
+                print_bytes(bye2, (uint16_t)(sizeof(bye2) - 1U));
                 return true;
             }
 
@@ -15,6 +15,8 @@ typedef enum {
     CMD_RESET,
     CMD_SET,
     CMD_HELP,
+    CMD_STATS,
+    CMD_TRACE,
     CMD_EXIT
 } cli_primary_t;
 
@@ -22,11 +24,14 @@ typedef enum {
     SUB_NONE = 0,
     SUB_CHANNEL,
     SUB_POWER,
+    SUB_ALL,
     SUB_CONFIG,
     SUB_DATA,
     SUB_ERRORS,
     SUB_OUTPUT,
-    SUB_DEFAULT
+    SUB_DEFAULT,
+    SUB_RESET,
+    SUB_DUMP
 } cli_secondary_t;
 
 /* Parsed command with already-validated arguments */
@@ -0,0 +1,104 @@
+#include "DataLink_Crc.h"
+
+/* All tables are expanded by the preprocessor into const arrays, so they live in flash
+ * (.rodata) and cost no RAM or boot time. A reflected table is linear over XOR: entry i is
+ * the XOR of the entries for each set bit of i. The entry for bit 7 is the reflected poly
+ * itself (0xD745 = reverse(0xA2EB)); each lower bit is one more CRC shift. */
+#define CRC16_STEP(c)          ((((c) & 1u) != 0u) ? (((c) >> 1) ^ 0xD745u) : ((c) >> 1))
+
+enum {
+  CRC16_K7 = 0xD745u,
+  CRC16_K6 = CRC16_STEP((unsigned)CRC16_K7),
+  CRC16_K5 = CRC16_STEP((unsigned)CRC16_K6),
+  CRC16_K4 = CRC16_STEP((unsigned)CRC16_K5),
+  CRC16_K3 = CRC16_STEP((unsigned)CRC16_K4),
+  CRC16_K2 = CRC16_STEP((unsigned)CRC16_K3),
+  CRC16_K1 = CRC16_STEP((unsigned)CRC16_K2),
+  CRC16_K0 = CRC16_STEP((unsigned)CRC16_K1)
+};
+
+/* Table entry 'i' from the basis constants P##0 .. P##7 */
+#define CRC16_BIT(i, b, P)     ((((i) & (1u << (b))) != 0u) ? (unsigned)P##b : 0u)
+#define CRC16_T1(i, P)         (uint16_t)(CRC16_BIT(i, 0, P) ^ CRC16_BIT(i, 1, P) ^ CRC16_BIT(i, 2, P) ^ CRC16_BIT(i, 3, P) ^ \
+                                          CRC16_BIT(i, 4, P) ^ CRC16_BIT(i, 5, P) ^ CRC16_BIT(i, 6, P) ^ CRC16_BIT(i, 7, P))
+#define CRC16_T4(i, P)         CRC16_T1(i, P),      CRC16_T1((i) + 1u, P),   CRC16_T1((i) + 2u, P),   CRC16_T1((i) + 3u, P)
+#define CRC16_T16(i, P)        CRC16_T4(i, P),      CRC16_T4((i) + 4u, P),   CRC16_T4((i) + 8u, P),   CRC16_T4((i) + 12u, P)
+#define CRC16_T64(i, P)        CRC16_T16(i, P),     CRC16_T16((i) + 16u, P), CRC16_T16((i) + 32u, P), CRC16_T16((i) + 48u, P)
+#define CRC16_TABLE(P)         { CRC16_T64(0u, P), CRC16_T64(64u, P), CRC16_T64(128u, P), CRC16_T64(192u, P) }
+
+#if (DL_CRC_KERNEL == DL_CRC_KERNEL_NIBBLE)
+
+/* Four shifts of a single nibble bit: the upper half of the byte basis. */
+#define CRC16_N1(j)            (uint16_t)(CRC16_BIT(j, 0, CRC16_K4_) ^ CRC16_BIT(j, 1, CRC16_K4_) ^ \
+                                          CRC16_BIT(j, 2, CRC16_K4_) ^ CRC16_BIT(j, 3, CRC16_K4_))
+enum {
+  CRC16_K4_0 = CRC16_K4, CRC16_K4_1 = CRC16_K5, CRC16_K4_2 = CRC16_K6, CRC16_K4_3 = CRC16_K7
+};
+
+const uint16_t crc16_nib[16] =
+{
+  CRC16_N1(0u),  CRC16_N1(1u),  CRC16_N1(2u),  CRC16_N1(3u),  CRC16_N1(4u),  CRC16_N1(5u),  CRC16_N1(6u),  CRC16_N1(7u),
+  CRC16_N1(8u),  CRC16_N1(9u),  CRC16_N1(10u), CRC16_N1(11u), CRC16_N1(12u), CRC16_N1(13u), CRC16_N1(14u), CRC16_N1(15u)
+};
+
+#else
+
+const uint16_t crc16_lut[256] = CRC16_TABLE(CRC16_K);
+
+#if (DL_CRC_KERNEL >= DL_CRC_KERNEL_SLICE2)
+/* Slicing tables: crc16_lutN[x] is the CRC contribution of byte x followed by N zero
+ * bytes, i.e. one more table round applied to each basis value of the previous table. */
+#define CRC16_NEXT(v)          (((unsigned)(v) >> 8) ^ CRC16_T1((unsigned)(v) & 0xFFu, CRC16_K))
+#define CRC16_NEXT_SET(D, S)   D##0 = CRC16_NEXT(S##0), D##1 = CRC16_NEXT(S##1), D##2 = CRC16_NEXT(S##2), D##3 = CRC16_NEXT(S##3), \
+                               D##4 = CRC16_NEXT(S##4), D##5 = CRC16_NEXT(S##5), D##6 = CRC16_NEXT(S##6), D##7 = CRC16_NEXT(S##7)
+
+enum { CRC16_NEXT_SET(CRC16_S1_, CRC16_K) };
+static const uint16_t crc16_lut1[256] = CRC16_TABLE(CRC16_S1_);
+#endif
+
+#if (DL_CRC_KERNEL >= DL_CRC_KERNEL_SLICE4)
+enum { CRC16_NEXT_SET(CRC16_S2_, CRC16_S1_) };
+enum { CRC16_NEXT_SET(CRC16_S3_, CRC16_S2_) };
+static const uint16_t crc16_lut2[256] = CRC16_TABLE(CRC16_S2_);
+static const uint16_t crc16_lut3[256] = CRC16_TABLE(CRC16_S3_);
+#endif
+
+#endif /* DL_CRC_KERNEL */
+
+/* Kept for compatibility: the tables are built at compile time, nothing to do at startup. */
+void crc16_init(void)
+{
+}
+
+/* Computes CRC16 (poly 0xA2EB, init provided by caller) over a byte span. */
+uint16_t crc16_compute(const uint8_t* data, uint16_t len, uint16_t init)
+{
+  uint32_t cs = init;
+
+#if (DL_CRC_KERNEL == DL_CRC_KERNEL_SLICE4)
+  /* the 16-bit CRC overlaps the first two bytes; the other two enter unmixed */
+  while (len >= 4u)
+  {
+    cs ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+    cs  = (uint32_t)crc16_lut3[cs & 0xFF] ^ crc16_lut2[cs >> 8] ^ crc16_lut1[data[2]] ^ crc16_lut[data[3]];
+    data += 4;
+    len   = (uint16_t)(len - 4u);
+  }
+#elif (DL_CRC_KERNEL == DL_CRC_KERNEL_SLICE2)
+  while (len >= 2u)
+  {
+    cs ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+    cs  = (uint32_t)crc16_lut1[cs & 0xFF] ^ crc16_lut[cs >> 8];
+    data += 2;
+    len   = (uint16_t)(len - 2u);
+  }
+#endif
+
+  while (len-- > 0)
+  {
+    crc16_ctx_t k = { (uint16_t)cs };
+    crc16_update(&k, *data++);
+    cs = k.crc;
+  }
+  return (uint16_t)cs;
+}
@@ -0,0 +1,81 @@
+#ifndef DATALINK_CRC_H
+#define DATALINK_CRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* CRC16 used by every DataLink frame: Ocean polynomial 0xA2EB (reflected), init 0xFFFF,
+ * CRC appended little-endian. Running the CRC over a whole frame including its trailer
+ * leaves a residue of 0. */
+#define CRC16_INIT             0xFFFFu							/* Start value for every frame. */
+
+/* CRC kernel, chosen at build time. All tables are const (flash), none cost RAM.
+ *   BYTE   - 256-entry table, one lookup per byte                          512 B flash
+ *   NIBBLE - 16-entry table, two lookups per byte; for flash-tight builds   32 B flash
+ *   SLICE2 - two 256-entry tables, crc16_compute() folds 2 bytes per step    1 KB flash
+ *   SLICE4 - four 256-entry tables, crc16_compute() folds 4 bytes per step   2 KB flash
+ * The slicing kernels only speed up whole spans (crc16_compute, i.e. the TX side);
+ * crc16_update() stays byte-wise with the first table since bytes arrive one by one.
+ * DataLink frames are at most 96 bytes, so BYTE is the default trade-off. */
+#define DL_CRC_KERNEL_BYTE     0
+#define DL_CRC_KERNEL_NIBBLE   1
+#define DL_CRC_KERNEL_SLICE2   2
+#define DL_CRC_KERNEL_SLICE4   3
+
+#ifndef DL_CRC_KERNEL
+#define DL_CRC_KERNEL          DL_CRC_KERNEL_BYTE				/* One of DL_CRC_KERNEL_*; override from the compiler command line. */
+#endif
+
+#if (DL_CRC_KERNEL < DL_CRC_KERNEL_BYTE) || (DL_CRC_KERNEL > DL_CRC_KERNEL_SLICE4)
+#error "DL_CRC_KERNEL must be one of DL_CRC_KERNEL_*"
+#endif
+
+#if (DL_CRC_KERNEL == DL_CRC_KERNEL_NIBBLE)
+/* 16-entry reflected lookup table (4 bits per step), const in flash. */
+extern const uint16_t crc16_nib[16];
+#else
+/* 256-entry reflected lookup table, const in flash. */
+extern const uint16_t crc16_lut[256];
+#endif
+
+/* Streaming CRC state: start once per frame, then feed bytes as they are produced or received. */
+typedef struct {
+    uint16_t crc;
+} crc16_ctx_t;
+
+/* No-op kept for compatibility; the CRC16 LUT (poly 0xA2EB, init 0xFFFF) is a const table in flash */
+void crc16_init(void);
+
+/* Computes CRC16 (poly 0xA2EB, init provided by caller) over a byte span. */
+uint16_t crc16_compute(const uint8_t* data, uint16_t len, uint16_t init);
+
+static inline void crc16_start(crc16_ctx_t* ctx)
+{
+  ctx->crc = CRC16_INIT;
+}
+
+static inline void crc16_update(crc16_ctx_t* ctx, uint8_t b)
+{
+#if (DL_CRC_KERNEL == DL_CRC_KERNEL_NIBBLE)
+  uint16_t c = (uint16_t)(ctx->crc ^ b);
+  c = (uint16_t)((c >> 4) ^ crc16_nib[c & 0x0Fu]);
+  ctx->crc = (uint16_t)((c >> 4) ^ crc16_nib[c & 0x0Fu]);
+#else
+  ctx->crc = (uint16_t)((ctx->crc >> 8) ^ crc16_lut[(uint8_t)(ctx->crc ^ b)]);
+#endif
+}
+
+/* True once a complete frame, CRC trailer included, has been fed in without error. */
+static inline bool crc16_residue_ok(const crc16_ctx_t* ctx)
+{
+  return ctx->crc == 0u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DATALINK_CRC_H */
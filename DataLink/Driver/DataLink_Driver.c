@@ -1,351 +1,1169 @@
 #include "DataLink_Driver.h"
-#include "main.h"     /* HAL_GetTick, HAL_Delay */
-#include "usart.h"    /* extern UART_HandleTypeDef huart1 */
+#include "DataLink_Crc.h"
+#include "DataLink_Trace.h"
 #include <string.h>
 
 /* =============================================================================
- * CRC16 (Ocean polynomial 0xA2EB) - identical logic as in v0.1.2 main.c
+ * Links - one context per DataLink connection; the legacy API uses the default
+ * link, which the board binds to USART1 in dl_rx_start()
  * ===========================================================================*/
-static uint16_t crc16_lut[256];
+static dl_link_t  s_link_default;
+static dl_link_t* s_links[DL_MAX_LINKS] = { &s_link_default };
+static uint16_t   s_link_count = 1u;
 
-/* Computes the 16-bit bit-reversal of the input. Used to build the CRC16 LUT. */
-static uint16_t reverse_bits16(uint16_t x)
+dl_status_t dl_link_init(dl_link_t* l, const dl_transport_t* tp, void* tp_ctx)
 {
-  x = (uint16_t)(((x >> 8) | (x << 8)));
-  x = (uint16_t)((((x & 0xF0F0u) >> 4) | ((x & 0x0F0Fu) << 4)));
-  x = (uint16_t)((((x & 0xCCCCu) >> 2) | ((x & 0x3333u) << 2)));
-  x = (uint16_t)((((x & 0xAAAAu) >> 1) | ((x & 0x5555u) << 1)));
+  uint16_t i;
 
-  return x;
-}
-
-/* Initializes a 256-entry CRC16 lookup table (poly 0xA2EB, init 0xFFFF). */
-void crc16_init(void)
-{
-  uint16_t poly = 0xA2EB;
-  uint16_t rp   = reverse_bits16(poly);
-  for (int i = 0; i < 256; ++i)
+  for (i = 0; i < s_link_count; ++i)
   {
-    uint16_t c = (uint16_t)i;
-    for (int b = 0; b < 8; ++b)
-    {
-      c = (uint16_t)(((c & 1u) ? ((c >> 1) ^ rp) : (c >> 1)));
-    }
-    crc16_lut[i] = c;
+    if (s_links[i] == l)
+      break;
   }
+  if (i == s_link_count)
+  {
+    if (s_link_count >= DL_MAX_LINKS)
+      return DL_ERR_BUSY;
+    s_links[s_link_count++] = l;
+  }
+
+  memset(l, 0, sizeof(*l));
+  l->tp     = tp;
+  l->tp_ctx = tp_ctx;
+  return DL_OK;
 }
 
-/* Computes CRC16 (poly 0xA2EB, init provided by caller) over a byte span. */
-static uint16_t crc16_compute(const uint8_t* data, uint16_t len, uint16_t init)
+dl_link_t* dl_link_default(void)
 {
-  uint32_t cs = init;
-  while (len-- > 0)
-  {
-    cs = (cs >> 8) ^ crc16_lut[*data++ ^ (uint8_t)(cs & 0xFF)];
-  }
-  return (uint16_t)cs;
+  return &s_link_default;
 }
 
 /* =============================================================================
- * HAL mapping helpers (keep HAL internal to .c)
+ * Line access - everything goes through the link's transport
  * ===========================================================================*/
-static inline dl_status_t dl_from_hal(HAL_StatusTypeDef s)
+/* Link clock in microseconds; spans are compared by unsigned difference, so the
+ * 32-bit wrap (~71 min) is harmless for anything shorter. */
+static uint32_t link_now(const dl_link_t* l)
 {
-  switch (s)
+  return l->tp->now_us(l->tp_ctx);
+}
+
+/* Microseconds since 't0', as whole milliseconds rounded up (deadlines never fire early). */
+static uint32_t link_ms_since(const dl_link_t* l, uint32_t t0)
+{
+  return (link_now(l) - t0 + 999u) / 1000u;
+}
+
+static bool link_expired(const dl_link_t* l, uint32_t t0, uint32_t ms)
+{
+  return (link_now(l) - t0) >= ms * 1000u;
+}
+
+static void link_delay(const dl_link_t* l, uint32_t ms)
+{
+  uint32_t t0 = link_now(l);
+  while (!link_expired(l, t0, ms))
   {
-    case HAL_OK:      return DL_OK;
-    case HAL_BUSY:    return DL_ERR_BUSY;
-    case HAL_TIMEOUT: return DL_ERR_TIMEOUT;
-    default:          return DL_ERR_LINK;
   }
 }
 
-/* Polling UART helper that reads exactly 'n' bytes within an overall deadline.
- * Returns DL_OK if 'n' bytes were read in time, otherwise DL_ERR_TIMEOUT/BUSY/LINK. */
-static dl_status_t uart_read_exact(uint8_t* p, uint16_t n, uint32_t overall_ms)
+/* Frame capture for offline analysis; only the default link (USART1 on the board) is
+ * traced, so host tools running many links from several threads never share the ring. */
+static void link_trace(const dl_link_t* l, uint8_t flags, const uint8_t* p, uint16_t n)
+{
+  if (l == &s_link_default)
+    dl_trace_record(link_now(l), flags, p, n);
+}
+
+static void link_send(dl_link_t* l, const uint8_t* p, uint16_t n)
 {
-  uint32_t t0 = HAL_GetTick();
+  link_trace(l, 0u, p, n);
+  (void)l->tp->send(l->tp_ctx, p, n);
+  l->cnt.tx_bytes += n;
+}
 
-  while (n) {
-    uint32_t now = HAL_GetTick();
-    if ((now - t0) >= overall_ms) return DL_ERR_TIMEOUT;
+/* True once when the transport reports bytes lost since the last call (or the last send). */
+static bool link_overrun(dl_link_t* l)
+{
+  uint32_t n;
+
+  if (l->tp->rx_lost == NULL)
+    return false;
+  n = l->tp->rx_lost(l->tp_ctx);
+  if (n == l->rx_lost)
+    return false;
+  l->rx_lost = n;
+  return true;
+}
 
-    uint32_t left  = overall_ms - (now - t0);
-    uint32_t slice = (left < 20u) ? left : 20u;
+static uint16_t link_recv(dl_link_t* l, uint8_t* p, uint16_t n, uint32_t wait_ms)
+{
+  uint16_t got = l->tp->recv(l->tp_ctx, p, n, wait_ms);
+  l->cnt.rx_bytes += got;
+  return got;
+}
+
+/* Reads exactly 'n' bytes within an overall deadline.
+ * Returns DL_OK if 'n' bytes arrived in time, otherwise DL_ERR_TIMEOUT. */
+static dl_status_t link_read_exact(dl_link_t* l, uint8_t* p, uint16_t n, uint32_t overall_ms)
+{
+  uint32_t t0 = link_now(l);
+  uint32_t waited = 0u;
 
-    HAL_StatusTypeDef hs = HAL_UART_Receive(&huart1, p, 1, slice);
-    if (hs == HAL_OK) { ++p; --n; continue; }
-    if (hs == HAL_TIMEOUT) continue; /* keep trying until deadline */
-    return dl_from_hal(hs);           /* BUSY/ERROR */
+  while (n) {
+    uint16_t got = link_recv(l, p, n, overall_ms - waited);
+    p += got;
+    n  = (uint16_t)(n - got);
+    if (n == 0u)
+      break;
+
+    if (link_expired(l, t0, overall_ms))
+      return DL_ERR_TIMEOUT;
+    waited = (link_now(l) - t0) / 1000u;
   }
 
   return DL_OK;
 }
 
+/* Discards incoming bytes until the line has been idle for DL_LINE_IDLE_CHARS character
+ * times, or 'max_ms' elapsed. */
+static void link_drain_idle(dl_link_t* l, uint32_t max_ms)
+{
+  l->tp->flush(l->tp_ctx, max_ms);
+}
+
 /* =============================================================================
  * DataLink handshake - identical logic as in v0.1.2 main.c (ported)
  * ===========================================================================*/
+static void eng_settle(dl_link_t* l);
+
 /* Device-initiated branch: wait RESET, reply with RESET_RESPONSE, drain line. */
-static bool dl_answer_device_reset(void)
+static bool dl_answer_device_reset(dl_link_t* l)
 {
   uint8_t rx[DL_OVERHEAD];
-  dl_status_t st = uart_read_exact(rx, DL_HDR_SIZE, 50u);
+  dl_status_t st = link_read_exact(l, rx, DL_HDR_SIZE, 50u);
   if (st != DL_OK)
 	  return false;
 
   if (rx[0] != DL_TYPE_RESET || rx[1] != DL_OVERHEAD)
 	  return false;
 
-  st = uart_read_exact(rx + 2, DL_CRC_SIZE, 50u);
+  st = link_read_exact(l, rx + 2, DL_CRC_SIZE, 50u);
   if (st != DL_OK)
 	  return false;
 
   if (crc16_compute(rx, DL_OVERHEAD, 0xFFFF) != 0)
 	  return false;
+  link_trace(l, DL_TRACE_RX, rx, DL_OVERHEAD);
 
   uint8_t tx[DL_OVERHEAD];
   tx[0] = DL_TYPE_RESET_RESP; tx[1] = DL_OVERHEAD;
   uint16_t c = crc16_compute(tx, DL_HDR_SIZE, 0xFFFF);
   tx[2] = (uint8_t)(c & 0xFF); tx[3] = (uint8_t)(c >> 8);
-  (void)HAL_UART_Transmit(&huart1, tx, DL_OVERHEAD, 20);
+  link_send(l, tx, DL_OVERHEAD);
 
-  HAL_Delay(125u);
-
-  /* drain line for up to 200 ms */
-  uint32_t t = HAL_GetTick(); uint8_t tmp;
-  while ((HAL_GetTick() - t) < 200u)
-  {
-    if (HAL_UART_Receive(&huart1, &tmp, 1, 20) != HAL_OK)
-    	break;
-  }
+  /* drain line for up to 200 ms (stops once the line is idle) */
+  link_drain_idle(l, 200u);
 
   return true;
 }
 
 /* Host-initiated branch: send RESET, expect RESET_RESPONSE, drain line. */
-static bool dl_host_reset(void)
+static bool dl_host_reset(dl_link_t* l)
 {
   uint8_t tx[DL_OVERHEAD], rx[DL_OVERHEAD];
   tx[0] = DL_TYPE_RESET; tx[1] = DL_OVERHEAD;
   uint16_t c = crc16_compute(tx, DL_HDR_SIZE, 0xFFFF);
   tx[2] = (uint8_t)(c & 0xFF); tx[3] = (uint8_t)(c >> 8);
-  (void)HAL_UART_Transmit(&huart1, tx, DL_OVERHEAD, 20);
+  l->tp->flush(l->tp_ctx, 0u);
+  link_send(l, tx, DL_OVERHEAD);
 
-  dl_status_t st = uart_read_exact(rx, DL_HDR_SIZE, 500u);
+  dl_status_t st = link_read_exact(l, rx, DL_HDR_SIZE, 500u);
   if (st != DL_OK)
 	  return false;
 
   if (rx[0] != DL_TYPE_RESET_RESP || rx[1] != DL_OVERHEAD)
 	  return false;
 
-  st = uart_read_exact(rx + 2, DL_CRC_SIZE, 500u);
+  st = link_read_exact(l, rx + 2, DL_CRC_SIZE, 500u);
   if (st != DL_OK)
 	  return false;
 
   if (crc16_compute(rx, DL_OVERHEAD, 0xFFFF) != 0)
 	  return false;
+  link_trace(l, DL_TRACE_RX, rx, DL_OVERHEAD);
 
-  HAL_Delay(125u);
-
-  /* drain line for up to 200 ms */
-  uint32_t t = HAL_GetTick(); uint8_t tmp;
-  while ((HAL_GetTick() - t) < 200u)
-  {
-    if (HAL_UART_Receive(&huart1, &tmp, 1, 20) != HAL_OK)
-    	break;
-  }
+  /* drain line for up to 200 ms (stops once the line is idle) */
+  link_drain_idle(l, 200u);
   return true;
 }
 
 /* High-level handshake: try device-reset branch repeatedly, then host-reset. */
-bool dl_handshake(void)
+bool dl_link_handshake(dl_link_t* l)
 {
+  if (l->tp == NULL)
+    return false;
+  eng_settle(l);
+
   for (int i = 0; i < 20; ++i)
   {
-    if (dl_answer_device_reset())
-    	return true;
+    if (dl_answer_device_reset(l))
+    {
+      l->cnt.full_handshakes++;
+      return true;
+    }
 
-    HAL_Delay(25);
+    link_delay(l, 25u);
   }
 
   for (int i = 0; i < 20; ++i)
   {
-    if (dl_host_reset())
-    	return true;
+    if (dl_host_reset(l))
+    {
+      l->cnt.full_handshakes++;
+      return true;
+    }
 
-    HAL_Delay(100);
+    link_delay(l, 100u);
   }
 
+  l->cnt.handshake_fail++;
   return false;
 }
 
-bool dl_handshake_quick(uint8_t ans_attempts, uint8_t host_attempts, uint32_t ans_gap_ms, uint32_t host_gap_ms)
+bool dl_link_handshake_quick(dl_link_t* l, uint8_t ans_attempts, uint8_t host_attempts, uint32_t ans_gap_ms, uint32_t host_gap_ms)
 {
+	if (l->tp == NULL)
+		return false;
+	eng_settle(l);
+
 	// Try a few quick "device-reset answer" windows
 	for (uint8_t i = 0; i < ans_attempts; ++i)
 	{
-		if (dl_answer_device_reset())
+		if (dl_answer_device_reset(l))
+		{
+			l->cnt.quick_handshakes++;
 			return true;
+		}
 
-		HAL_Delay(ans_gap_ms);
+		link_delay(l, ans_gap_ms);
 	}
 
 	// Then a few quick host-initiated resets
 	for (uint8_t i = 0; i < host_attempts; ++i)
 	{
-		if (dl_host_reset())
+		if (dl_host_reset(l))
+		{
+			l->cnt.quick_handshakes++;
 			return true;
+		}
 
-		HAL_Delay(host_gap_ms);
+		link_delay(l, host_gap_ms);
 	}
 
+	l->cnt.handshake_fail++;
 	return false;
 }
 
+bool dl_handshake(void)
+{
+  return dl_link_handshake(&s_link_default);
+}
+
+bool dl_handshake_quick(uint8_t ans_attempts, uint8_t host_attempts, uint32_t ans_gap_ms, uint32_t host_gap_ms)
+{
+  return dl_link_handshake_quick(&s_link_default, ans_attempts, host_attempts, ans_gap_ms, host_gap_ms);
+}
+
 /* =============================================================================
- * Low-level transactions - identical logic as in v0.1.2 main.c (ported)
+ * Round-trip estimation - Jacobson/Karels smoothed RTT and mean deviation, kept
+ * per frame type and length class, in fixed point (srtt x8, rttvar x4), with Karn's
+ * backoff: a timeout doubles the class deadline and the doubling stays until a response
+ * to a first attempt gives a valid sample. A retry's response may answer an earlier
+ * attempt, so retries are never sampled - without the kept backoff a slower device
+ * would time out forever against the old estimate.
  * ===========================================================================*/
-/* READ: send (type=0x02, total=overhead+3, addr LSB/MSB, len, CRC), wait RESP */
-dl_status_t dl_read(uint16_t addr, uint8_t len, uint8_t* outBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs)
+static dl_rtt_class_t* rtt_class(dl_link_t* l, uint8_t type, uint8_t len)
 {
-  uint8_t  tx[8];
-  uint8_t  rx[96];
-  uint16_t total;
-  uint16_t c;
+  uint8_t b = (uint8_t)(len / DL_RTT_BUCKET_BYTES);
+  if (b >= DL_RTT_LEN_BUCKETS)
+    b = DL_RTT_LEN_BUCKETS - 1u;
 
-  tx[0] = DL_TYPE_READ;
-  tx[1] = (uint8_t)(DL_OVERHEAD + 3u);
-  tx[2] = (uint8_t)(addr & 0xFF);
-  tx[3] = (uint8_t)(addr >> 8);
-  tx[4] = len;
-  c = crc16_compute(tx, (uint16_t)(DL_HDR_SIZE + 3u), 0xFFFF);
-  tx[5] = (uint8_t)(c & 0xFF);
-  tx[6] = (uint8_t)(c >> 8);
-  (void)HAL_UART_Transmit(&huart1, tx, 7u, 20);
+  return &l->rtt[(type == DL_TYPE_WRITE) ? 1 : 0][b];
+}
 
-  dl_status_t st = uart_read_exact(rx, 2, headerWaitMs);
+static void rtt_sample(dl_rtt_est_t* e, bool first, uint32_t r_ms)
+{
+  int32_t m;
 
-  if (st != DL_OK)
-	  return st;                             /* timeout/busy/link */
+  if (r_ms > DL_RTT_MAX_MS)
+    r_ms = DL_RTT_MAX_MS;
 
-  if (rx[0] != DL_TYPE_READ_RESP)
-	  return DL_ERR_INVALID_RESPONSE;
+  if (first)
+  {
+    e->srtt8 = (uint16_t)(r_ms << 3);
+    e->var4  = (uint16_t)(r_ms << 1);     /* rttvar = R/2 */
+    return;
+  }
 
-  total = rx[1];
-  if (total < (DL_OVERHEAD + 4u) || total > sizeof(rx))
-	  return DL_ERR_INVALID_RESPONSE;
+  m = (int32_t)r_ms - (int32_t)(e->srtt8 >> 3);
+  e->srtt8 = (uint16_t)((int32_t)e->srtt8 + m);          /* srtt += err/8 */
+  if (m < 0)
+    m = -m;
+  m -= (int32_t)(e->var4 >> 2);
+  e->var4 = (uint16_t)((int32_t)e->var4 + m);            /* rttvar += (|err| - rttvar)/4 */
+}
 
-  st = uart_read_exact(rx + 2, (uint16_t)(total - 2), payloadWaitMs);
-  if (st != DL_OK)
-	  return st;
+/* srtt + 4 x rttvar, clamped, then doubled by the class backoff or this attempt's, whichever is more (capped). */
+static uint32_t rtt_timeout(const dl_rtt_class_t* c, const dl_rtt_est_t* e, uint8_t backoff)
+{
+  uint32_t t = (c->samples == 0u) ? DL_RTT_INIT_MS : (uint32_t)(e->srtt8 >> 3) + e->var4;
+  uint8_t  n = (c->backoff > backoff) ? c->backoff : backoff;
+
+  if (t < DL_RTT_MIN_MS)
+    t = DL_RTT_MIN_MS;
+  while (n-- > 0u && t < DL_RTT_MAX_MS)
+    t <<= 1;
+
+  return (t > DL_RTT_MAX_MS) ? DL_RTT_MAX_MS : t;
+}
+
+/* 'op' timed out: its class deadline doubles past the one that just expired. */
+static void rtt_backoff(dl_link_t* l, const dl_op_t* op)
+{
+  dl_rtt_class_t* c = rtt_class(l, op->type, op->len);
+  uint16_t        n = (uint16_t)(((c->backoff > op->backoff) ? c->backoff : op->backoff) + 1u);
+
+  c->backoff = (n > 0xFFu) ? 0xFFu : (uint8_t)n;
+}
+
+bool dl_link_rtt_query(const dl_link_t* l, uint8_t type, uint8_t len, dl_rtt_info_t* out)
+{
+  if (out == NULL || (type != DL_TYPE_READ && type != DL_TYPE_WRITE))
+    return false;
+
+  const dl_rtt_class_t* c = rtt_class((dl_link_t*)l, type, len);
+  out->samples        = c->samples;
+  out->hdr_srtt_ms    = (uint16_t)(c->hdr.srtt8 >> 3);
+  out->hdr_rttvar_ms  = (uint16_t)(c->hdr.var4 >> 2);
+  out->hdr_timeout_ms = (uint16_t)rtt_timeout(c, &c->hdr, 0u);
+  out->pay_srtt_ms    = (uint16_t)(c->pay.srtt8 >> 3);
+  out->pay_rttvar_ms  = (uint16_t)(c->pay.var4 >> 2);
+  out->pay_timeout_ms = (uint16_t)rtt_timeout(c, &c->pay, 0u);
+  out->backoff        = c->backoff;
+
+  return true;
+}
+
+bool dl_rtt_query(uint8_t type, uint8_t len, dl_rtt_info_t* out)
+{
+  return dl_link_rtt_query(&s_link_default, type, len, out);
+}
+
+/* Log2 latency bucket: 0 for < 1 ms, b for [2^(b-1), 2^b) ms, capped at the last bucket. */
+static uint8_t hist_bucket(uint32_t ms)
+{
+  uint8_t b = 0u;
+
+  while (ms != 0u && b < (DL_HIST_BUCKETS - 1u))
+  {
+    ms >>= 1;
+    b++;
+  }
+  return b;
+}
+
+/* =============================================================================
+ * Transaction engine - queued, non-blocking READ/WRITE driven by dl_poll()
+ * ===========================================================================*/
+typedef enum {
+  DL_ENG_IDLE = 0,                        /* nothing on the wire */
+  DL_ENG_WAIT_HDR,                        /* request sent, waiting for type + length */
+  DL_ENG_WAIT_BODY                        /* header seen, waiting for the rest of the frame */
+} dl_eng_state_t;
+
+#define DL_RESP_HEAD           (DL_HDR_SIZE + 4u)   /* type, total, status, addr LSB/MSB, size */
+
+/* Where receive-window byte 'i' lives, and how many bytes fit there contiguously. Normally
+ * the window is 'frame'; for a zero-copy READ response the data bytes go straight to the
+ * caller's buffer and only the response head and the CRC stay in 'frame'. */
+static uint8_t* eng_window_at(dl_link_t* l, uint16_t i, uint16_t* room)
+{
+  if (l->zc && i >= DL_RESP_HEAD)
+  {
+    uint16_t k = (uint16_t)(i - DL_RESP_HEAD);
+
+    if (k < l->zc_len)
+    {
+      *room = (uint16_t)(l->zc_len - k);
+      return &l->q[l->q_head].rbuf[k];
+    }
+    k = (uint16_t)(k - l->zc_len);
+    *room = (uint16_t)(DL_CRC_SIZE - k);
+    return &l->frame[DL_RESP_HEAD + k];
+  }
+
+  *room = (uint16_t)((l->zc ? DL_RESP_HEAD : DL_MAX_FRAME) - i);
+  return &l->frame[i];
+}
+
+/* Moves up to 'n' buffered bytes into the receive window and runs them through the CRC. */
+static uint16_t eng_take(dl_link_t* l, uint16_t n)
+{
+  uint16_t took = 0u;
+
+  while (took < n)
+  {
+    uint16_t room;
+    uint8_t* p    = eng_window_at(l, l->got, &room);
+    uint16_t want = (uint16_t)(n - took);
+    uint16_t got;
+
+    if (want > room)
+      want = room;
+    got = link_recv(l, p, want, 0u);
+
+    for (uint16_t i = 0; i < got; ++i)
+      crc16_update(&l->crc, p[i]);
+    l->got = (uint16_t)(l->got + got);
+    took   = (uint16_t)(took + got);
+
+    if (got < want)
+      break;
+  }
+
+  return took;
+}
 
-  if (crc16_compute(rx, total, 0xFFFF) != 0)
-	  return DL_ERR_INVALID_RESPONSE;
+/* A zero-copy candidate failed: gather it back into 'frame' so the resync scanner can
+ * slide over it like any other window. Rare, so the copy is paid only here. */
+static void eng_unzc(dl_link_t* l)
+{
+  if (!l->zc)
+    return;
 
-  /* parse response payload: status(1), addr(2), size(1), data(size) */
+  memmove(&l->frame[DL_RESP_HEAD + l->zc_len], &l->frame[DL_RESP_HEAD], DL_CRC_SIZE);
+  memcpy(&l->frame[DL_RESP_HEAD], l->q[l->q_head].rbuf, l->zc_len);
+  l->zc = false;
+}
+
+/* Traces the first 'n' bytes of the receive window, wherever they live. */
+static void eng_trace(dl_link_t* l, uint8_t flags, uint16_t n)
+{
+  uint8_t  snap[DL_TRACE_SNAP];
+  uint16_t room;
+
+  if (!l->zc)
+  {
+    link_trace(l, flags, l->frame, n);
+    return;
+  }
+
+  for (uint16_t i = 0; i < n && i < DL_TRACE_SNAP; ++i)
+    snap[i] = *eng_window_at(l, i, &room);
+  link_trace(l, flags, snap, n);
+}
+
+/* Resync scanner: drops the first byte of the receive window so the scan for a frame
+ * start resumes one byte later, and re-runs the CRC over what is left. */
+static void eng_slide(dl_link_t* l)
+{
+  l->got--;
+  memmove(l->frame, &l->frame[1], l->got);
+  l->cnt.resync_bytes++;
+
+  crc16_start(&l->crc);
+  for (uint16_t i = 0; i < l->got; ++i)
+    crc16_update(&l->crc, l->frame[i]);
+}
+
+/* A plausible response header for 'op': the matching response type and a length that
+ * fits it (a READ_RESP carries at most the requested data). */
+static bool eng_hdr_plausible(const dl_op_t* op, const uint8_t* h)
+{
+  if (op->type == DL_TYPE_READ)
+    return h[0] == DL_TYPE_READ_RESP && h[1] >= (DL_OVERHEAD + 4u) && h[1] <= (DL_OVERHEAD + 4u + op->len);
+
+  return h[0] == DL_TYPE_WRITE_RESP && h[1] == (DL_OVERHEAD + 4u);
+}
+
+/* Builds and sends the request frame for 'op'; the CRC is accumulated while the
+ * frame is assembled, so the payload is touched only once. */
+static void eng_send(dl_link_t* l, const dl_op_t* op)
+{
+  uint8_t*    f = l->frame;               /* idle until the response arrives, reuse for TX */
+  uint8_t     n = (op->type == DL_TYPE_WRITE) ? op->len : 0u;
+  uint8_t     i;
+  crc16_ctx_t k;
+
+  f[0] = op->type;
+  f[1] = (uint8_t)(DL_OVERHEAD + 3u + n);
+  f[2] = (uint8_t)(op->addr & 0xFF);
+  f[3] = (uint8_t)(op->addr >> 8);
+  f[4] = op->len;
+
+  crc16_start(&k);
+  for (i = 0; i < 5u; ++i)
+    crc16_update(&k, f[i]);
+  for (i = 0; i < n; ++i)
+  {
+    f[5 + i] = op->wbuf[i];
+    crc16_update(&k, f[5 + i]);
+  }
+
+  f[5 + n] = (uint8_t)(k.crc & 0xFF);
+  f[6 + n] = (uint8_t)(k.crc >> 8);
+
+  l->tp->flush(l->tp_ctx, 0u);            /* drop stale bytes from earlier exchanges */
+  link_send(l, f, (uint16_t)(7u + n));
+  l->cnt.tx_frames++;
+}
+
+/* Validates a CRC-checked frame against 'op' and, for READ, copies the data out unless
+ * it was received in place ('zc'). Type and length were already screened by eng_hdr_plausible().
+ * READ_RESP  payload: status(1), addr(2), size(1), data(size)
+ * WRITE_RESP payload: status(1), addr(2), size(1) */
+static dl_status_t eng_parse(const dl_op_t* op, const uint8_t* rx, uint16_t total, bool zc)
+{
   uint8_t  status = rx[2];
   uint16_t raddr  = (uint16_t)rx[3] | ((uint16_t)rx[4] << 8);
   uint8_t  size   = rx[5];
-  if (status != 0 || raddr != addr || size != len)
-	  return DL_ERR_INVALID_RESPONSE;
+  if (status != 0 || raddr != op->addr || size != op->len)
+    return DL_ERR_INVALID_RESPONSE;
 
-  memcpy(outBuf, &rx[6], len);
+  if (op->type == DL_TYPE_READ)
+  {
+    if (total != (DL_OVERHEAD + 4u + size))
+      return DL_ERR_INVALID_RESPONSE;
+    if (!zc)
+      memcpy(op->rbuf, &rx[DL_RESP_HEAD], op->len);
+  }
 
   return DL_OK;
 }
 
-/* Read-with-retry: call dl_read; on failure, handshake and retry up to DL_CMD_RETRIES. */
-dl_status_t dl_read_retry(uint16_t addr, uint8_t len, uint8_t* outBuf)
+/* Retires the active op and reports it. The engine is idle again before the
+ * callback runs, so the callback may submit (or even block on) new transactions. */
+static void eng_finish(dl_link_t* l, dl_status_t st)
+{
+  dl_callback_t cb  = l->q[l->q_head].cb;
+  void*         ctx = l->q[l->q_head].ctx;
+
+  if (st == DL_ERR_INVALID_RESPONSE)
+    l->cnt.invalid++;
+
+  l->q_head = (uint8_t)((l->q_head + 1u) % DL_ASYNC_QUEUE_LEN);
+  l->q_count--;
+  l->eng = DL_ENG_IDLE;
+
+  if (cb)
+    cb(st, ctx);
+
+  /* a failed op takes the ops chained behind it along, unsent, with its status */
+  while (st != DL_OK && l->q_count != 0u && l->q[l->q_head].chained)
+  {
+    cb  = l->q[l->q_head].cb;
+    ctx = l->q[l->q_head].ctx;
+    l->q_head = (uint8_t)((l->q_head + 1u) % DL_ASYNC_QUEUE_LEN);
+    l->q_count--;
+    if (cb)
+      cb(st, ctx);
+  }
+}
+
+/* Queues one transaction. */
+static dl_status_t eng_submit(dl_link_t* l, uint8_t type, uint16_t addr, uint8_t len, uint8_t* rbuf, const uint8_t* wbuf,
+                              uint32_t hdr_ms, uint32_t pay_ms, uint8_t backoff, dl_callback_t cb, void* ctx)
+{
+  if (type == DL_TYPE_WRITE && len > DL_MAX_WRITE)
+    return DL_ERR_INVALID_RESPONSE;     /* same constraint as original */
+  if (type == DL_TYPE_READ && len > DL_MAX_READ)
+    return DL_ERR_INVALID_RESPONSE;
+  if (l->tp == NULL)
+    return DL_ERR_LINK;
+  if (l->q_count >= DL_ASYNC_QUEUE_LEN)
+    return DL_ERR_BUSY;
+
+  dl_op_t* op = &l->q[(l->q_head + l->q_count) % DL_ASYNC_QUEUE_LEN];
+  op->type    = type;
+  op->addr    = addr;
+  op->len     = len;
+  op->rbuf    = rbuf;
+  op->wbuf    = wbuf;
+  op->hdr_ms  = hdr_ms;
+  op->pay_ms  = pay_ms;
+  op->backoff = backoff;
+  op->chained = false;
+  op->cb      = cb;
+  op->ctx     = ctx;
+  l->q_count++;
+
+  return DL_OK;
+}
+
+dl_status_t dl_link_read_async(dl_link_t* l, uint16_t addr, uint8_t len, uint8_t* outBuf, dl_callback_t cb, void* ctx)
+{
+  return eng_submit(l, DL_TYPE_READ, addr, len, outBuf, NULL, DL_WAIT_AUTO, DL_WAIT_AUTO, 0u, cb, ctx);
+}
+
+dl_status_t dl_link_write_async(dl_link_t* l, uint16_t addr, uint8_t len, const uint8_t* inBuf, dl_callback_t cb, void* ctx)
+{
+  return eng_submit(l, DL_TYPE_WRITE, addr, len, NULL, inBuf, DL_WAIT_AUTO, DL_WAIT_AUTO, 0u, cb, ctx);
+}
+
+dl_status_t dl_read_async(uint16_t addr, uint8_t len, uint8_t* outBuf, dl_callback_t cb, void* ctx)
+{
+  return dl_link_read_async(&s_link_default, addr, len, outBuf, cb, ctx);
+}
+
+dl_status_t dl_write_async(uint16_t addr, uint8_t len, const uint8_t* inBuf, dl_callback_t cb, void* ctx)
+{
+  return dl_link_write_async(&s_link_default, addr, len, inBuf, cb, ctx);
+}
+
+/* Advances the link's engine by at most one stage; never blocks on the line. */
+bool dl_link_poll(dl_link_t* l)
+{
+  /* part of the response was lost on receive: no CRC will pass, so fail now rather than
+   * at the deadline, and drop what is left of it */
+  if (l->eng != DL_ENG_IDLE && link_overrun(l))
+  {
+    l->cnt.overruns++;
+    eng_trace(l, DL_TRACE_RX | DL_TRACE_OVERRUN, l->got);
+    l->tp->flush(l->tp_ctx, 0u);
+    eng_finish(l, DL_ERR_INVALID_RESPONSE);
+    return (l->q_count != 0u);
+  }
+
+  switch ((dl_eng_state_t)l->eng)
+  {
+    case DL_ENG_IDLE:
+    {
+      if (l->q_count == 0u)
+        return false;
+
+      dl_op_t*              op = &l->q[l->q_head];
+      const dl_rtt_class_t* c  = rtt_class(l, op->type, op->len);
+
+      if (op->hdr_ms == DL_WAIT_AUTO)
+        op->hdr_ms = rtt_timeout(c, &c->hdr, op->backoff);
+      if (op->pay_ms == DL_WAIT_AUTO)
+        op->pay_ms = rtt_timeout(c, &c->pay, op->backoff);
+
+      eng_send(l, op);
+      (void)link_overrun(l);              /* losses before this request do not concern it */
+      l->got      = 0u;
+      l->crc_fail = false;
+      l->zc       = false;
+      crc16_start(&l->crc);
+      l->sent     = link_now(l);
+      l->t0       = l->sent;
+      l->eng      = DL_ENG_WAIT_HDR;
+      break;
+    }
+
+    case DL_ENG_WAIT_HDR:
+    {
+      const dl_op_t* op = &l->q[l->q_head];
+
+      /* listen while the request is still going out; the deadline runs from its last byte */
+      if (l->tp->tx_busy != NULL && l->tp->tx_busy(l->tp_ctx))
+      {
+        l->sent = link_now(l);
+        l->t0   = l->sent;
+      }
+
+      /* hunt byte by byte for something that looks like the expected response */
+      for (;;)
+      {
+        if (l->got < DL_HDR_SIZE)
+          (void)eng_take(l, (uint16_t)(DL_HDR_SIZE - l->got));
+        if (l->got < DL_HDR_SIZE || eng_hdr_plausible(op, l->frame))
+          break;
+        eng_slide(l);
+      }
+
+      if (l->got < DL_HDR_SIZE && l->crc_fail)
+      {
+        /* a whole frame arrived but nothing in it resyncs: it was corrupted, not shifted */
+        eng_finish(l, DL_ERR_INVALID_RESPONSE);
+      }
+      else if (l->got >= DL_HDR_SIZE)
+      {
+        l->total   = l->frame[1];
+        /* a fresh READ_RESP header: receive its data straight into the caller's buffer */
+        l->zc      = (l->got == DL_HDR_SIZE && op->type == DL_TYPE_READ);
+        l->zc_len  = (uint8_t)(l->total - DL_RESP_HEAD - DL_CRC_SIZE);
+        l->t0      = link_now(l);
+        l->hdr_rtt = l->t0 - l->sent;
+        l->eng     = DL_ENG_WAIT_BODY;
+      }
+      else if (link_expired(l, l->t0, op->hdr_ms))
+      {
+        l->cnt.hdr_timeouts++;
+        rtt_backoff(l, op);
+        link_trace(l, DL_TRACE_RX | DL_TRACE_TIMEOUT, l->frame, l->got);
+        eng_finish(l, DL_ERR_TIMEOUT);
+      }
+      break;
+    }
+
+    case DL_ENG_WAIT_BODY:
+      if (l->got < l->total)
+        (void)eng_take(l, (uint16_t)(l->total - l->got));
+      if (l->got >= l->total)
+      {
+        const dl_op_t* op = &l->q[l->q_head];
+
+        /* after a slide the window may already run past this candidate */
+        bool crc_ok = (l->got == l->total) ? crc16_residue_ok(&l->crc)
+                                           : (crc16_compute(l->frame, l->total, CRC16_INIT) == 0u);
+        if (!crc_ok)
+        {
+          /* false start or corrupted byte: resume the hunt one byte later */
+          l->crc_fail = true;
+          l->cnt.crc_fail++;
+          eng_unzc(l);
+          link_trace(l, DL_TRACE_RX | DL_TRACE_CRC_BAD, l->frame, l->total);
+          eng_slide(l);
+          l->eng = DL_ENG_WAIT_HDR;
+          break;
+        }
+
+        dl_status_t st = eng_parse(op, l->frame, l->total, l->zc);
+        eng_trace(l, (st == DL_OK) ? DL_TRACE_RX : (DL_TRACE_RX | DL_TRACE_REJECTED), l->total);
+
+        /* only a frame that validated, in answer to a first attempt, is a trustworthy sample */
+        if (st == DL_OK)
+        {
+          dl_rtt_class_t* c     = rtt_class(l, op->type, op->len);
+          bool            first = (c->samples == 0u);
+
+          if (op->backoff == 0u)
+          {
+            rtt_sample(&c->hdr, first, (l->hdr_rtt + 999u) / 1000u);
+            rtt_sample(&c->pay, first, link_ms_since(l, l->t0));
+            if (c->samples < 0xFFFFu)
+              c->samples++;
+            c->backoff = 0u;
+          }
+          l->cnt.rx_frames++;
+          l->cnt.hist[op->type == DL_TYPE_WRITE][hist_bucket((link_now(l) - l->sent) / 1000u)]++;
+        }
+        eng_finish(l, st);
+      }
+      else if (link_expired(l, l->t0, l->q[l->q_head].pay_ms))
+      {
+        l->cnt.pay_timeouts++;
+        rtt_backoff(l, &l->q[l->q_head]);
+        eng_trace(l, DL_TRACE_RX | DL_TRACE_TIMEOUT, l->got);
+        eng_finish(l, DL_ERR_TIMEOUT);
+      }
+      break;
+  }
+
+  return (l->q_count != 0u);
+}
+
+uint32_t dl_link_poll_timeout(const dl_link_t* l)
+{
+  uint32_t limit, waited;
+
+  switch ((dl_eng_state_t)l->eng)
+  {
+    case DL_ENG_IDLE:
+      return (l->q_count != 0u) ? 0u : DL_POLL_NO_DEADLINE;
+    case DL_ENG_WAIT_HDR:
+      limit = l->q[l->q_head].hdr_ms;
+      break;
+    default:
+      limit = l->q[l->q_head].pay_ms;
+      break;
+  }
+
+  if (link_expired(l, l->t0, limit))
+    return 0u;
+  waited = (link_now(l) - l->t0) / 1000u;     /* round the remainder up: no early wake-up */
+  return limit - waited;
+}
+
+bool dl_poll(void)
+{
+  bool busy = false;
+
+  for (uint16_t i = 0; i < s_link_count; ++i)
+  {
+    if (dl_link_poll(s_links[i]))
+      busy = true;
+  }
+  return busy;
+}
+
+/* Lets an in-flight transaction complete before something else takes the line. */
+static void eng_settle(dl_link_t* l)
+{
+  while (l->eng != DL_ENG_IDLE)
+    (void)dl_link_poll(l);
+}
+
+/* =============================================================================
+ * Blocking transactions - thin wrappers over the engine
+ * ===========================================================================*/
+typedef struct {
+  volatile bool        done;
+  volatile dl_status_t st;
+} dl_wait_t;
+
+static void wait_done(dl_status_t st, void* ctx)
+{
+  dl_wait_t* w = (dl_wait_t*)ctx;
+  w->st   = st;
+  w->done = true;
+}
+
+/* Submits and polls until this transaction completes; queued async work
+ * from other clients is serviced in order along the way. */
+static dl_status_t eng_run(dl_link_t* l, uint8_t type, uint16_t addr, uint8_t len, uint8_t* rbuf, const uint8_t* wbuf,
+                           uint32_t hdr_ms, uint32_t pay_ms, uint8_t backoff)
+{
+  dl_wait_t   w = { false, DL_ERR_LINK };
+  dl_status_t st;
+
+  while ((st = eng_submit(l, type, addr, len, rbuf, wbuf, hdr_ms, pay_ms, backoff, wait_done, &w)) == DL_ERR_BUSY)
+    (void)dl_link_poll(l);
+  if (st != DL_OK)
+    return st;
+
+  while (!w.done)
+    (void)dl_link_poll(l);
+
+  return w.st;
+}
+
+/* Tiered recovery: the cheapest step that can plausibly fix the link first. A lost or
+ * corrupted frame only needs the line drained; a device that stopped answering needs a
+ * resync; only a link that keeps failing pays for the full handshake (seconds). */
+static void link_recover(dl_link_t* l)
+{
+  if (l->fail_run < 0xFFu)
+    l->fail_run++;
+
+  if (l->fail_run <= DL_RECOVER_FLUSH)
+  {
+    l->recover = DL_RECOVER_LVL_FLUSH;
+    link_drain_idle(l, DL_RTT_MIN_MS);    /* let a late/partial frame finish, then drop it */
+  }
+  else if (l->fail_run <= DL_RECOVER_QUICK)
+  {
+    l->recover = DL_RECOVER_LVL_QUICK;
+    (void)dl_link_handshake_quick(l, DL_RESYNC_ANS_ATTEMPTS, DL_RESYNC_HOST_ATTEMPTS,
+                                  DL_RESYNC_ANS_GAP_MS, DL_RESYNC_HOST_GAP_MS);
+  }
+  else
+  {
+    l->recover = DL_RECOVER_LVL_FULL;
+    (void)dl_link_handshake(l);
+  }
+}
+
+static void link_ok(dl_link_t* l)
+{
+  l->fail_run = 0u;
+  l->recover  = DL_RECOVER_NONE;
+}
+
+dl_recover_level_t dl_link_recover_level(const dl_link_t* l, uint8_t* out_failures)
+{
+  if (out_failures)
+    *out_failures = l->fail_run;
+  return l->recover;
+}
+
+dl_recover_level_t dl_recover_level(uint8_t* out_failures)
+{
+  return dl_link_recover_level(&s_link_default, out_failures);
+}
+
+void dl_link_get_counters(const dl_link_t* l, dl_link_counters_t* out)
+{
+  if (out)
+    *out = l->cnt;
+}
+
+void dl_link_reset_counters(dl_link_t* l)
+{
+  memset(&l->cnt, 0, sizeof l->cnt);
+}
+
+void dl_get_counters(dl_link_counters_t* out)
+{
+  dl_link_get_counters(&s_link_default, out);
+}
+
+void dl_reset_counters(void)
+{
+  dl_link_reset_counters(&s_link_default);
+}
+
+uint32_t dl_hist_bucket_ms(uint8_t b)
+{
+  return (b == 0u) ? 0u : (1UL << (b - 1u));
+}
+
+/* READ: send (type=0x02, total=overhead+3, addr LSB/MSB, len, CRC), wait RESP */
+dl_status_t dl_link_read(dl_link_t* l, uint16_t addr, uint8_t len, uint8_t* outBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs)
+{
+  return eng_run(l, DL_TYPE_READ, addr, len, outBuf, NULL, headerWaitMs, payloadWaitMs, 0u);
+}
+
+/* Read-with-retry: call dl_read; on failure, recover and retry up to DL_CMD_RETRIES. */
+dl_status_t dl_link_read_retry(dl_link_t* l, uint16_t addr, uint8_t len, uint8_t* outBuf)
 {
   dl_status_t last = DL_ERR_LINK;
   for (int attempt = 0; attempt < (int)DL_CMD_RETRIES; ++attempt)
   {
-    dl_status_t st = dl_read(addr, len, outBuf, /*header*/500u, /*payload*/500u);
+    if (attempt > 0)
+      l->cnt.retries++;
+    dl_status_t st = eng_run(l, DL_TYPE_READ, addr, len, outBuf, NULL, DL_WAIT_AUTO, DL_WAIT_AUTO, (uint8_t)attempt);
     if (st == DL_OK)
-    	return DL_OK;
+    {
+      link_ok(l);
+      return DL_OK;
+    }
 
     last = st;
-    (void)dl_handshake(); /* re-sync and retry */
+    link_recover(l); /* escalating re-sync, then retry */
   }
 
   return last;
 }
 
 /* WRITE: send (type=0x01, total=overhead+3+len, addr LSB/MSB, size, data, CRC), wait RESP */
-dl_status_t dl_write(uint16_t addr, uint8_t len, const uint8_t* inBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs)
+dl_status_t dl_link_write(dl_link_t* l, uint16_t addr, uint8_t len, const uint8_t* inBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs)
+{
+  return eng_run(l, DL_TYPE_WRITE, addr, len, NULL, inBuf, headerWaitMs, payloadWaitMs, 0u);
+}
+
+/* Write-with-retry: call dl_write; on failure, recover and retry. */
+dl_status_t dl_link_write_retry(dl_link_t* l, uint16_t addr, uint8_t len, const uint8_t* inBuf)
 {
-  if (len > 32u)
-	  return DL_ERR_INVALID_RESPONSE; /* same constraint as original */
+  dl_status_t last = DL_ERR_LINK;
+  for (int attempt = 0; attempt < (int)DL_CMD_RETRIES; ++attempt)
+  {
+    if (attempt > 0)
+      l->cnt.retries++;
+    dl_status_t st = eng_run(l, DL_TYPE_WRITE, addr, len, NULL, inBuf, DL_WAIT_AUTO, DL_WAIT_AUTO, (uint8_t)attempt);
+    if (st == DL_OK)
+    {
+      link_ok(l);
+      return DL_OK;
+    }
+
+    last = st;
+    link_recover(l); /* escalating re-sync, then retry */
+  }
 
-  uint8_t  frame[7 + 32 + 2];
-  uint16_t total = (uint16_t)(DL_OVERHEAD + 3u + len);
+  return last;
+}
+
+dl_status_t dl_read(uint16_t addr, uint8_t len, uint8_t* outBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs)
+{
+  return dl_link_read(&s_link_default, addr, len, outBuf, headerWaitMs, payloadWaitMs);
+}
+
+dl_status_t dl_read_retry(uint16_t addr, uint8_t len, uint8_t* outBuf)
+{
+  return dl_link_read_retry(&s_link_default, addr, len, outBuf);
+}
 
-  frame[0] = DL_TYPE_WRITE;
-  frame[1] = (uint8_t)total;
-  frame[2] = (uint8_t)(addr & 0xFF);
-  frame[3] = (uint8_t)(addr >> 8);
-  frame[4] = len;
+dl_status_t dl_write(uint16_t addr, uint8_t len, const uint8_t* inBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs)
+{
+  return dl_link_write(&s_link_default, addr, len, inBuf, headerWaitMs, payloadWaitMs);
+}
 
-  if (len)
-	  memcpy(&frame[5], inBuf, len);
+dl_status_t dl_write_retry(uint16_t addr, uint8_t len, const uint8_t* inBuf)
+{
+  return dl_link_write_retry(&s_link_default, addr, len, inBuf);
+}
 
-  uint16_t c = crc16_compute(frame, (uint16_t)(DL_HDR_SIZE + 3u + len), 0xFFFF);
-  frame[5 + len] = (uint8_t)(c & 0xFF);
-  frame[6 + len] = (uint8_t)(c >> 8);
 
-  (void)HAL_UART_Transmit(&huart1, frame, (uint16_t)(7u + len), 50);
+/* =============================================================================
+ * Batched reads - merge nearby register ranges into as few READ frames as fit
+ * ===========================================================================*/
+/* Reads one merged span and scatters it to the requests sorted[first..last]. */
+static dl_status_t batch_read_span(dl_link_t* l, const dl_read_req_t* reqs, const uint8_t* sorted,
+                                   uint8_t first, uint8_t last, uint16_t start, uint16_t end)
+{
+  uint8_t span[DL_MAX_READ];
+  uint8_t n = (uint8_t)(end - start);
 
-  /* Expect response: type=WRITE_RESP, total=DL_OVERHEAD+4, payload=status(1)+addr(2)+size(1) */
-  uint8_t  rxh[2];
-  dl_status_t st = uart_read_exact(rxh, 2, headerWaitMs);
+  /* a lone request that was not widened needs no bounce buffer */
+  if (first == last && reqs[sorted[first]].addr == start && reqs[sorted[first]].len == n)
+    return dl_link_read_retry(l, start, n, reqs[sorted[first]].dest);
 
+  dl_status_t st = dl_link_read_retry(l, start, n, span);
   if (st != DL_OK)
-	  return st;
+    return st;
 
-  if (rxh[0] != DL_TYPE_WRITE_RESP)
-	  return DL_ERR_INVALID_RESPONSE;
+  for (uint8_t i = first; i <= last; ++i)
+  {
+    const dl_read_req_t* r = &reqs[sorted[i]];
+    memcpy(r->dest, &span[r->addr - start], r->len);
+  }
 
-  uint16_t rtotal = rxh[1];
-  if (rtotal != (DL_OVERHEAD + 4u))
-	  return DL_ERR_INVALID_RESPONSE;
+  return DL_OK;
+}
 
-  /* read full tail = payload(4) + CRC(2) = 6 bytes */
-  uint8_t rtail[6];
-  st = uart_read_exact(rtail, 6, payloadWaitMs);
-  if (st != DL_OK)
-	  return st;
+dl_status_t dl_link_read_batch(dl_link_t* l, const dl_read_req_t* reqs, uint8_t count)
+{
+  uint8_t sorted[DL_BATCH_MAX];
 
-  uint8_t full[8];
-  full[0] = rxh[0];
-  full[1] = rxh[1];
-  memcpy(&full[2], rtail, sizeof(rtail));
+  if (count == 0u)
+    return DL_OK;
+  if (count > DL_BATCH_MAX)
+    return DL_ERR_BUSY;
 
-  if (crc16_compute(full, rtotal, 0xFFFF) != 0)
-	  return DL_ERR_INVALID_RESPONSE;
+  /* order by address (insertion sort: batches are tiny) */
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    if (reqs[i].len == 0u || reqs[i].len > DL_MAX_READ)
+      return DL_ERR_INVALID_RESPONSE;
 
-  uint8_t  status = full[2];
-  uint16_t raddr  = (uint16_t)full[3] | ((uint16_t)full[4] << 8);
-  uint8_t  rsize  = full[5];
+    uint8_t j = i;
+    while (j > 0u && reqs[sorted[j - 1u]].addr > reqs[i].addr)
+    {
+      sorted[j] = sorted[j - 1u];
+      --j;
+    }
+    sorted[j] = i;
+  }
 
-  if (status != 0 || raddr != addr || rsize != len)
-	  return DL_ERR_INVALID_RESPONSE;
+  /* grow a span while the next range overlaps or sits within DL_COALESCE_GAP bytes,
+   * and the merged span still fits one response frame */
+  uint8_t  first = 0;
+  uint16_t start = reqs[sorted[0]].addr;
+  uint16_t end   = (uint16_t)(start + reqs[sorted[0]].len);
+
+  for (uint8_t i = 1; i <= count; ++i)
+  {
+    if (i < count)
+    {
+      const dl_read_req_t* r = &reqs[sorted[i]];
+      uint16_t r_end   = (uint16_t)(r->addr + r->len);
+      uint16_t new_end = (r_end > end) ? r_end : end;
+
+      if ((uint32_t)r->addr <= (uint32_t)end + DL_COALESCE_GAP && (uint16_t)(new_end - start) <= DL_MAX_READ)
+      {
+        end = new_end;
+        continue;
+      }
+    }
+
+    dl_status_t st = batch_read_span(l, reqs, sorted, first, (uint8_t)(i - 1u), start, end);
+    if (st != DL_OK)
+      return st;
+
+    if (i < count)
+    {
+      first = i;
+      start = reqs[sorted[i]].addr;
+      end   = (uint16_t)(start + reqs[sorted[i]].len);
+    }
+  }
 
   return DL_OK;
 }
 
-/* Write-with-retry: call dl_write; on failure, handshake and retry. */
-dl_status_t dl_write_retry(uint16_t addr, uint8_t len, const uint8_t* inBuf)
+dl_status_t dl_read_batch(const dl_read_req_t* reqs, uint8_t count)
 {
-  dl_status_t last = DL_ERR_LINK;
-  for (int attempt = 0; attempt < (int)DL_CMD_RETRIES; ++attempt)
+  return dl_link_read_batch(&s_link_default, reqs, count);
+}
+
+/* =============================================================================
+ * Write-and-verify - WRITE and its read-back READ pipelined under one deadline
+ * ===========================================================================*/
+/* Adaptive deadline of a 'type'/'len' stage for this attempt, capped by what is left. */
+static uint32_t verify_wait(dl_link_t* l, uint8_t type, uint8_t len, bool hdr, uint8_t backoff, uint32_t left_ms)
+{
+  dl_rtt_class_t* c  = rtt_class(l, type, len);
+  uint32_t        ms = rtt_timeout(c, hdr ? &c->hdr : &c->pay, backoff);
+
+  return (ms < left_ms) ? ms : left_ms;
+}
+
+dl_status_t dl_link_write_verify(dl_link_t* l, uint16_t addr, uint8_t len, const uint8_t* inBuf,
+                                 uint32_t budget_ms, dl_phase_t* out_phase)
+{
+  uint8_t     rb[DL_MAX_WRITE];
+  uint32_t    t0      = link_now(l);
+  dl_status_t last    = DL_ERR_TIMEOUT;
+  dl_phase_t  phase   = DL_PHASE_WRITE;
+  bool        written = false;            /* WRITE acknowledged: retries only repeat the READ */
+
+  if (len == 0u || len > DL_MAX_WRITE || l->tp == NULL)
   {
-    dl_status_t st = dl_write(addr, len, inBuf, /*header*/500u, /*payload*/500u);
-    if (st == DL_OK)
-    	return DL_OK;
-    last = st;
-    (void)dl_handshake(); /* re-sync and retry */
+    if (out_phase)
+      *out_phase = DL_PHASE_WRITE;
+    return (l->tp == NULL) ? DL_ERR_LINK : DL_ERR_INVALID_RESPONSE;
+  }
+
+  for (uint8_t attempt = 0; attempt < DL_CMD_RETRIES; ++attempt)
+  {
+    dl_wait_t   ww = { true, DL_OK };
+    dl_wait_t   wr = { false, DL_ERR_LINK };
+    uint32_t    left;
+
+    if (link_expired(l, t0, budget_ms))
+      break;
+    if (attempt > 0u)
+      l->cnt.retries++;
+    left = budget_ms - (link_now(l) - t0) / 1000u;
+
+    /* both ops must be queued back to back, so wait for two free slots */
+    while (l->q_count > (DL_ASYNC_QUEUE_LEN - 2u))
+      (void)dl_link_poll(l);
+
+    if (!written)
+    {
+      ww.done = false;
+      (void)eng_submit(l, DL_TYPE_WRITE, addr, len, NULL, inBuf, verify_wait(l, DL_TYPE_WRITE, len, true, attempt, left),
+                       verify_wait(l, DL_TYPE_WRITE, len, false, attempt, left), attempt, wait_done, &ww);
+    }
+    (void)eng_submit(l, DL_TYPE_READ, addr, len, rb, NULL, verify_wait(l, DL_TYPE_READ, len, true, attempt, left),
+                     verify_wait(l, DL_TYPE_READ, len, false, attempt, left), attempt, wait_done, &wr);
+    l->q[(l->q_head + l->q_count - 1u) % DL_ASYNC_QUEUE_LEN].chained = !written;
+
+    while (!wr.done)
+      (void)dl_link_poll(l);
+
+    if (ww.st != DL_OK)
+    {
+      last  = ww.st;
+      phase = DL_PHASE_WRITE;
+    }
+    else if (wr.st != DL_OK)
+    {
+      written = true;
+      last    = wr.st;
+      phase   = DL_PHASE_READ;
+    }
+    else
+    {
+      link_ok(l);
+      last  = (memcmp(rb, inBuf, len) == 0) ? DL_OK : DL_ERR_MISMATCH;
+      phase = (last == DL_OK) ? DL_PHASE_NONE : DL_PHASE_COMPARE;
+      break;                            /* the link works; a mismatch is the device's answer */
+    }
+
+    link_recover(l);                    /* escalating re-sync, then retry */
   }
 
+  if (out_phase)
+    *out_phase = phase;
   return last;
 }
 
+dl_status_t dl_write_verify(uint16_t addr, uint8_t len, const uint8_t* inBuf, uint32_t budget_ms, dl_phase_t* out_phase)
+{
+  return dl_link_write_verify(&s_link_default, addr, len, inBuf, budget_ms, out_phase);
+}
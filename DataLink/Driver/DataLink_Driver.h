@@ -7,11 +7,16 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "DataLink_Crc.h"   /* crc16_init, crc16_ctx_t */
+#include "DataLink_Transport.h"
 
 /* Protocol framing & constants */
 #define DL_HDR_SIZE            2u								/* Number of bytes in the DataLink frame header (type + total length). */
 #define DL_CRC_SIZE            2u								/* Number of bytes in the DataLink frame CRC trailer (CRC16 LE). */
 #define DL_OVERHEAD            (DL_HDR_SIZE + DL_CRC_SIZE)		/* Total non-payload overhead per frame (header + CRC). */
+#define DL_MAX_FRAME           96u								/* Largest response frame accepted (type..CRC). */
+#define DL_MAX_READ            (DL_MAX_FRAME - DL_OVERHEAD - 4u)	/* Largest READ length: frame minus overhead and status/addr/size. */
+#define DL_MAX_WRITE           32u								/* Largest WRITE payload per frame. */
 
 /* Package types */
 #define DL_TYPE_RESET          0x7Fu							/* DataLink frame type: RESET (device or host issues to resync link). */
@@ -21,8 +26,62 @@ extern "C" {
 #define DL_TYPE_WRITE          0x01u							/* DataLink frame type: WRITE request (host → device; applies contiguous bytes at addr). */
 #define DL_TYPE_WRITE_RESP     0x81u							/* DataLink frame type: WRITE_RESPONSE (device → host; echoes status, addr, size). */
 
+/* Asynchronous transaction engine */
+#define DL_ASYNC_QUEUE_LEN     4u								/* Transactions that can be queued ahead of dl_poll(); submit returns DL_ERR_BUSY beyond this. */
+
+/* Links */
+#define DL_POLL_NO_DEADLINE    0xFFFFFFFFu						/* dl_link_poll_timeout(): nothing in flight or queued. */
+#ifndef DL_MAX_LINKS
+#define DL_MAX_LINKS           2u								/* Links registered with dl_link_init() and stepped by dl_poll(), the default link included. */
+#endif
+
+/* Adaptive response deadlines (Jacobson/Karels): smoothed RTT + 4 x variance, per frame type and length bucket.
+ * A timeout doubles the class deadline (Karn) until the next valid sample; retries take no samples. */
+#define DL_WAIT_AUTO           0u								/* Pass as header/payload wait to use the deadline derived from the RTT estimate. */
+#ifndef DL_RTT_INIT_MS
+#define DL_RTT_INIT_MS         500u								/* Deadline before a class has any sample (the former fixed wait). */
+#endif
+#ifndef DL_RTT_MIN_MS
+#define DL_RTT_MIN_MS          20u								/* Lower clamp: absorbs 1 ms tick granularity and scheduling jitter. */
+#endif
+#ifndef DL_RTT_MAX_MS
+#define DL_RTT_MAX_MS          500u								/* Upper clamp, also caps the retry backoff. */
+#endif
+#define DL_RTT_LEN_BUCKETS     4u								/* Length classes per frame type; a 96-byte frame takes ~100 ms at 9600 baud. */
+#define DL_RTT_BUCKET_BYTES    24u								/* Payload bytes per length class. */
+
+/* Statistics: log2 latency buckets; bucket 0 is < 1 ms, bucket b >= 1 holds [2^(b-1), 2^b) ms, the last is open-ended */
+#define DL_HIST_BUCKETS        10u								/* 0, 1, 2-3, 4-7 ... 128-255, >= 256 ms; two histograms per link fit in 80 bytes. */
+
+/* Batched reads */
+#define DL_BATCH_MAX           8u								/* Requests accepted by one dl_read_batch() call. */
+#define DL_COALESCE_GAP        16u								/* Unrequested bytes worth reading to bridge two ranges; ~one READ exchange of overhead at 9600 baud. */
+
+/* Write-and-verify */
+#define DL_VERIFY_BUDGET_MS    1000u							/* Default shared deadline for a dl_write_verify() pair, retries included. */
+
 /* Simple retry policy for command helpers */
-#define DL_CMD_RETRIES         3u								/* Number of command attempts (READ/WRITE) before giving up; on failure a handshake is attempted to re-synchronize before retrying. Tunable for link robustness. */
+#define DL_CMD_RETRIES         3u								/* Number of command attempts (READ/WRITE) before giving up; each failure runs one recovery step before retrying. Tunable for link robustness. */
+
+/* Line-idle detection (transport flush): a drain ends once the line has been quiet this long */
+#ifndef DL_LINE_IDLE_CHARS
+#define DL_LINE_IDLE_CHARS     4u								/* Character times (10 bits each) of silence that end a drain; ~4 ms at 9600 baud. */
+#endif
+
+/* Tiered recovery: escalates with consecutive failed attempts, resets on the first success */
+#define DL_RECOVER_FLUSH       1u								/* Failures answered by draining the line and retrying at once. */
+#define DL_RECOVER_QUICK       3u								/* Failures (up to this count) answered by a bounded quick resync. */
+#define DL_RESYNC_ANS_ATTEMPTS 2u								/* Quick resync: device-reset answer windows. */
+#define DL_RESYNC_HOST_ATTEMPTS 2u								/* Quick resync: host-initiated resets. */
+#define DL_RESYNC_ANS_GAP_MS   25u								/* Quick resync: pause between answer windows. */
+#define DL_RESYNC_HOST_GAP_MS  80u								/* Quick resync: pause between host resets. */
+
+typedef enum {
+    DL_RECOVER_NONE = 0,     /* link healthy */
+    DL_RECOVER_LVL_FLUSH,    /* last step: drain + immediate retry */
+    DL_RECOVER_LVL_QUICK,    /* last step: dl_handshake_quick() */
+    DL_RECOVER_LVL_FULL      /* last step: dl_handshake() */
+} dl_recover_level_t;
 
 /* Local DataLink status */
 typedef enum {
@@ -30,15 +89,131 @@ typedef enum {
     DL_ERR_BUSY,
     DL_ERR_TIMEOUT,
     DL_ERR_INVALID_RESPONSE,
-    DL_ERR_LINK
+    DL_ERR_LINK,
+    DL_ERR_MISMATCH          /* dl_write_verify: read-back differs from what was written */
 } dl_status_t;
 
+/* Phase of dl_write_verify() that decided its result */
+typedef enum {
+    DL_PHASE_NONE = 0,       /* verified */
+    DL_PHASE_WRITE,          /* the WRITE failed or was rejected */
+    DL_PHASE_READ,           /* the WRITE was acknowledged, the read-back failed */
+    DL_PHASE_COMPARE         /* the read-back arrived but differs (DL_ERR_MISMATCH) */
+} dl_phase_t;
+
+/* One register range of a batched read */
+typedef struct {
+    uint16_t addr;
+    uint8_t  len;
+    uint8_t* dest;
+} dl_read_req_t;
+
+/* Current round-trip estimate of one (frame type, length) class, in ms.
+ * Header stage: request sent -> response header received.
+ * Payload stage: header received -> last byte received. */
+typedef struct {
+    uint16_t samples;
+    uint16_t hdr_srtt_ms;
+    uint16_t hdr_rttvar_ms;
+    uint16_t hdr_timeout_ms;      /* deadline dl_read/dl_write use with DL_WAIT_AUTO */
+    uint16_t pay_srtt_ms;
+    uint16_t pay_rttvar_ms;
+    uint16_t pay_timeout_ms;
+    uint8_t  backoff;             /* doublings carried over from timeouts, cleared by the next valid sample */
+} dl_rtt_info_t;
+
+/* Completion callback for asynchronous transactions; runs from dl_poll(), never from an ISR. */
+typedef void (*dl_callback_t)(dl_status_t status, void* ctx);
+
+/* Per-link event counters and latency histograms (dl_get_counters / dl_reset_counters) */
+typedef struct {
+    uint32_t tx_frames;           /* requests sent */
+    uint32_t rx_frames;           /* responses accepted */
+    uint32_t tx_bytes;            /* bytes handed to the transport, handshakes included */
+    uint32_t rx_bytes;            /* bytes taken from the transport, noise and drained bytes excluded */
+    uint32_t crc_fail;            /* candidate frames that failed their CRC */
+    uint32_t hdr_timeouts;        /* transactions with no plausible response header in time */
+    uint32_t pay_timeouts;        /* transactions whose header arrived but the body did not */
+    uint32_t invalid;             /* corrupted frames and rejected responses */
+    uint32_t retries;             /* repeated attempts made by the *_retry calls */
+    uint32_t resync_bytes;        /* bytes skipped while hunting for a frame start */
+    uint32_t overruns;            /* transactions failed early because response bytes were lost on receive */
+    uint32_t full_handshakes;     /* successful dl_handshake() */
+    uint32_t quick_handshakes;    /* successful dl_handshake_quick() */
+    uint32_t handshake_fail;      /* handshakes of either kind that gave up */
+    uint32_t hist[2][DL_HIST_BUCKETS];  /* [0] READ, [1] WRITE: successful transactions by send -> completion time */
+} dl_link_counters_t;
+
+/* -------------------------------------------------------------------------- */
+/* Link context                                                               */
+/* -------------------------------------------------------------------------- */
+/* Everything one DataLink connection needs: its transport, transaction queue,
+ * RTT estimates, recovery state and counters. The fields are private to the driver; the
+ * type is public only so links can be allocated statically. */
+typedef struct {
+    uint8_t        type;                    /* DL_TYPE_READ / DL_TYPE_WRITE */
+    uint8_t        len;
+    uint16_t       addr;
+    uint8_t*       rbuf;                    /* READ destination (caller-owned) */
+    const uint8_t* wbuf;                    /* WRITE source (caller-owned) */
+    uint32_t       hdr_ms;                  /* DL_WAIT_AUTO: resolved from the RTT estimate at send */
+    uint32_t       pay_ms;
+    uint8_t        backoff;                 /* doublings applied to adaptive deadlines */
+    bool           chained;                 /* dropped unsent when the op before it fails */
+    dl_callback_t  cb;
+    void*          ctx;
+} dl_op_t;
+
+typedef struct {
+    uint16_t srtt8;                         /* smoothed RTT, ms x 8 */
+    uint16_t var4;                          /* mean deviation, ms x 4 */
+} dl_rtt_est_t;
+
+typedef struct {
+    dl_rtt_est_t hdr;                       /* send -> header */
+    dl_rtt_est_t pay;                       /* header -> last byte */
+    uint16_t     samples;
+    uint8_t      backoff;                   /* Karn: doublings kept from timeouts until a valid sample */
+} dl_rtt_class_t;
+
+typedef struct {
+    const dl_transport_t* tp;               /* byte transport, see DataLink_Transport.h */
+    void*              tp_ctx;              /* backend port passed to every transport hook */
+
+    /* transaction engine */
+    dl_op_t            q[DL_ASYNC_QUEUE_LEN];
+    uint8_t            q_head;              /* index of the active / next op */
+    uint8_t            q_count;
+    uint8_t            eng;                 /* engine state (driver-internal) */
+    bool               crc_fail;            /* a complete candidate frame failed its CRC */
+    bool               zc;                  /* READ data of the candidate lands in the op's rbuf, not 'frame' */
+    uint8_t            zc_len;              /* data bytes of that candidate */
+    uint16_t           total;               /* announced length of the frame being received */
+    uint16_t           got;                 /* bytes in the receive window 'frame' */
+    uint32_t           sent;                /* when the active request went out (link clock, us) */
+    uint32_t           t0;                  /* start of the current wait stage (us) */
+    uint32_t           hdr_rtt;             /* measured send -> header time of the active op (us) */
+    uint32_t           rx_lost;             /* transport overrun count when the active op was sent */
+    crc16_ctx_t        crc;                 /* running CRC over frame[0..got) */
+    uint8_t            frame[DL_MAX_FRAME];
+
+    /* adaptive deadlines, recovery */
+    dl_rtt_class_t     rtt[2][DL_RTT_LEN_BUCKETS];
+    uint8_t            fail_run;            /* consecutive failed attempts, across commands */
+    dl_recover_level_t recover;
+
+    dl_link_counters_t cnt;
+} dl_link_t;
+
 /* -------------------------------------------------------------------------- */
 /* Public API                                                                 */
 /* -------------------------------------------------------------------------- */
 
-/* Build CRC16 LUT once at startup (poly 0xA2EB, init 0xFFFF) */
-void crc16_init(void);
+/* USART1 receive via circular ReceiveToIdle DMA: start once after MX_USART1_UART_Init();
+ * this also binds the default link to USART1. The ISR hook is called from USART1_IRQHandler
+ * ahead of HAL_UART_IRQHandler. Both live in the HAL transport (DataLink_TransportHal.c). */
+void dl_rx_start(void);
+void dl_rx_irq_handler(void);
 
 /* Synchronize link (device/host reset handshake). Returns true if OK. */
 bool dl_handshake(void);
@@ -47,7 +222,21 @@ bool dl_handshake(void);
 bool dl_handshake_quick(uint8_t ans_attempts, uint8_t host_attempts,
                         uint32_t ans_gap_ms, uint32_t host_gap_ms);
 
-/* Low-level blocking transactions */
+/* Asynchronous transactions: queue a single attempt (no retry/handshake, adaptive deadlines) and return at once.
+ * Buffers must stay valid until 'cb' runs. A READ response is received straight into
+ * 'outBuf', so its contents are undefined unless 'cb' gets DL_OK. Returns DL_OK if queued,
+ * DL_ERR_BUSY if the queue is full, DL_ERR_INVALID_RESPONSE if 'len' cannot fit one frame. */
+dl_status_t dl_read_async (uint16_t addr, uint8_t len, uint8_t* outBuf, dl_callback_t cb, void* ctx);
+dl_status_t dl_write_async(uint16_t addr, uint8_t len, const uint8_t* inBuf, dl_callback_t cb, void* ctx);
+
+/* Drives the transaction engine one step without blocking; call from the main loop /
+ * idle hooks. Transactions run one at a time in submission order. Steps every registered
+ * link; returns true while anything is still queued or in flight on any of them. */
+bool dl_poll(void);
+
+/* Low-level blocking transactions (wrappers: submit, then dl_poll() until done).
+ * Either wait may be DL_WAIT_AUTO to use the adaptive deadline. dl_read receives in place:
+ * on any status other than DL_OK the contents of 'outBuf' are undefined. */
 dl_status_t dl_read(
     uint16_t addr, uint8_t len,
     uint8_t* outBuf,
@@ -58,10 +247,79 @@ dl_status_t dl_write(
     const uint8_t* inBuf,
     uint32_t headerWaitMs, uint32_t payloadWaitMs);
 
-/* Convenience wrappers with retry + handshake on failure */
+/* Convenience wrappers with retry + tiered recovery on failure; adaptive deadlines, doubled per attempt.
+ * As with dl_read, 'outBuf' is undefined unless the result is DL_OK. */
 dl_status_t dl_read_retry (uint16_t addr, uint8_t len, uint8_t* outBuf);
 dl_status_t dl_write_retry(uint16_t addr, uint8_t len, const uint8_t* inBuf);
 
+/* Batched read: merges overlapping / nearby ranges into the fewest READ frames that fit
+ * DL_MAX_READ, reads each with dl_read_retry, and scatters the bytes to every 'dest'.
+ * Stops at the first failing frame and returns its status; every 'dest' is then undefined
+ * (frames before the failing one may already be filled in). */
+dl_status_t dl_read_batch(const dl_read_req_t* reqs, uint8_t count);
+
+/* Write-and-verify: WRITE 'len' bytes at 'addr' and READ the same range back, queued
+ * together so the READ goes out the moment the WRITE response is in. One deadline of
+ * 'budget_ms' covers both frames and any retries (a recovery step already running still
+ * finishes); failures are retried like dl_write_retry, a mismatch is not. Once the WRITE
+ * is acknowledged, retries repeat only the READ, so a device that stalls after the write
+ * is not reconfigured again.
+ * Returns DL_OK if the read-back equals 'inBuf'; '*out_phase' (may be NULL) says which
+ * phase failed otherwise. */
+dl_status_t dl_write_verify(uint16_t addr, uint8_t len, const uint8_t* inBuf, uint32_t budget_ms, dl_phase_t* out_phase);
+
+/* Recovery escalation of the link and the consecutive failed attempts behind it. */
+dl_recover_level_t dl_recover_level(uint8_t* out_failures);
+
+/* Reports the RTT estimate used for a 'type' (DL_TYPE_READ / DL_TYPE_WRITE) transfer of
+ * 'len' bytes. Returns false for any other type. */
+bool dl_rtt_query(uint8_t type, uint8_t len, dl_rtt_info_t* out);
+
+/* Snapshot and reset of the link counters; dl_hist_bucket_ms() gives the lower bound of
+ * histogram bucket 'b' in ms. */
+void     dl_get_counters(dl_link_counters_t* out);
+void     dl_reset_counters(void);
+uint32_t dl_hist_bucket_ms(uint8_t b);
+
+/* -------------------------------------------------------------------------- */
+/* Per-link API                                                               */
+/* -------------------------------------------------------------------------- */
+/* Every function above works on the default link (USART1 on the board) and is a wrapper
+ * over the dl_link_* form below, which takes the link explicitly. */
+
+/* Prepares 'link' on transport 'tp' / port 'tp_ctx' and registers it with dl_poll().
+ * The port must already be open. Returns DL_ERR_BUSY when DL_MAX_LINKS links are
+ * registered. Transactions on a link without a transport fail with DL_ERR_LINK. */
+dl_status_t dl_link_init(dl_link_t* link, const dl_transport_t* tp, void* tp_ctx);
+dl_link_t*  dl_link_default(void);
+
+bool        dl_link_handshake(dl_link_t* link);
+bool        dl_link_handshake_quick(dl_link_t* link, uint8_t ans_attempts, uint8_t host_attempts,
+                                    uint32_t ans_gap_ms, uint32_t host_gap_ms);
+
+dl_status_t dl_link_read_async (dl_link_t* link, uint16_t addr, uint8_t len, uint8_t* outBuf, dl_callback_t cb, void* ctx);
+dl_status_t dl_link_write_async(dl_link_t* link, uint16_t addr, uint8_t len, const uint8_t* inBuf, dl_callback_t cb, void* ctx);
+bool        dl_link_poll(dl_link_t* link);
+
+/* Milliseconds until dl_link_poll() must run even if no byte arrives: 0 when a queued
+ * request is waiting to be sent or a deadline has passed, DL_POLL_NO_DEADLINE when the
+ * link is idle. Lets an event loop sleep on the transport (select/epoll, WFI) in between. */
+uint32_t    dl_link_poll_timeout(const dl_link_t* link);
+
+dl_status_t dl_link_read (dl_link_t* link, uint16_t addr, uint8_t len, uint8_t* outBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs);
+dl_status_t dl_link_write(dl_link_t* link, uint16_t addr, uint8_t len, const uint8_t* inBuf, uint32_t headerWaitMs, uint32_t payloadWaitMs);
+dl_status_t dl_link_read_retry (dl_link_t* link, uint16_t addr, uint8_t len, uint8_t* outBuf);
+dl_status_t dl_link_write_retry(dl_link_t* link, uint16_t addr, uint8_t len, const uint8_t* inBuf);
+
+dl_status_t dl_link_read_batch (dl_link_t* link, const dl_read_req_t* reqs, uint8_t count);
+dl_status_t dl_link_write_verify(dl_link_t* link, uint16_t addr, uint8_t len, const uint8_t* inBuf,
+                                 uint32_t budget_ms, dl_phase_t* out_phase);
+
+dl_recover_level_t dl_link_recover_level(const dl_link_t* link, uint8_t* out_failures);
+bool        dl_link_rtt_query(const dl_link_t* link, uint8_t type, uint8_t len, dl_rtt_info_t* out);
+void        dl_link_get_counters(const dl_link_t* link, dl_link_counters_t* out);
+void        dl_link_reset_counters(dl_link_t* link);
+
 
 #ifdef __cplusplus
 }
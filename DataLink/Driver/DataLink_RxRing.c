@@ -0,0 +1,70 @@
+#include "DataLink_RxRing.h"
+
+/* Keeps the compiler from moving buffer accesses across index updates.
+ * Cortex-M0+ is single-core and in-order, so a compiler barrier is sufficient. */
+#define DL_RING_BARRIER()      __asm volatile ("" ::: "memory")
+
+#define DL_RING_MASK           (DL_RX_RING_SIZE - 1u)
+
+/* Empties the ring and clears the drop counter. */
+void dl_rx_ring_reset(dl_rx_ring_t* r)
+{
+  r->head    = 0u;
+  r->tail    = 0u;
+  r->dropped = 0u;
+}
+
+/* Producer (DMA): the data is already in place, only publish it. A circular DMA does
+ * not stop at a full ring, so anything beyond one ring length is lost. While the consumer
+ * lags, the overflow of earlier commits is still part of head - tail and was counted then;
+ * only the bytes this commit overwrites are added. */
+void dl_rx_ring_commit(dl_rx_ring_t* r, uint16_t n)
+{
+  uint16_t tail = r->tail;
+  uint16_t was  = (uint16_t)(r->head - tail);
+  uint16_t head = (uint16_t)(r->head + n);
+  uint16_t used = (uint16_t)(head - tail);
+
+  if (used > DL_RX_RING_SIZE)
+  {
+    uint16_t lost = (was > DL_RX_RING_SIZE) ? (uint16_t)(was - DL_RX_RING_SIZE) : 0u;
+    r->dropped += (uint32_t)(used - DL_RX_RING_SIZE - lost);
+  }
+
+  DL_RING_BARRIER();
+  r->head = head;
+}
+
+/* Consumer: copy out what is available, then release the slots by advancing tail. */
+uint16_t dl_rx_ring_read(dl_rx_ring_t* r, uint8_t* dst, uint16_t n)
+{
+  uint16_t tail  = r->tail;
+  uint16_t avail = (uint16_t)(r->head - tail);
+  uint16_t i;
+
+  if (avail > DL_RX_RING_SIZE)
+  {
+    /* producer lapped us: skip the bytes that were overwritten */
+    tail  = (uint16_t)(r->head - DL_RX_RING_SIZE);
+    avail = DL_RX_RING_SIZE;
+  }
+
+  if (n > avail)
+    n = avail;
+
+  DL_RING_BARRIER();
+  for (i = 0u; i < n; ++i)
+  {
+    dst[i] = r->buf[(uint16_t)(tail + i) & DL_RING_MASK];
+  }
+  DL_RING_BARRIER();
+  r->tail = (uint16_t)(tail + n);
+
+  return n;
+}
+
+/* Consumer: drop everything the producer has published so far. */
+void dl_rx_ring_flush(dl_rx_ring_t* r)
+{
+  r->tail = r->head;
+}
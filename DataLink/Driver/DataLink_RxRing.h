@@ -0,0 +1,50 @@
+#ifndef DATALINK_RXRING_H
+#define DATALINK_RXRING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Receive ring sizing (must be a power of two) */
+#ifndef DL_RX_RING_SIZE
+#define DL_RX_RING_SIZE        128u								/* Bytes buffered between the USART1 ISR and the driver; holds > one max frame (96 B). */
+#endif
+
+#if (DL_RX_RING_SIZE & (DL_RX_RING_SIZE - 1u)) != 0u
+#error "DL_RX_RING_SIZE must be a power of two"
+#endif
+
+/* Single-producer (ISR) / single-consumer (thread) byte ring.
+ * head is only written by the producer, tail only by the consumer, so no lock is needed.
+ * Indices run freely and are masked on access; count = head - tail.
+ * The producer is a circular DMA writing 'buf' directly, which then publishes its
+ * progress with dl_rx_ring_commit. */
+typedef struct {
+    uint8_t           buf[DL_RX_RING_SIZE];
+    volatile uint16_t head;       /* next write position (producer) */
+    volatile uint16_t tail;       /* next read position (consumer)  */
+    volatile uint32_t dropped;    /* bytes lost because the ring was full */
+} dl_rx_ring_t;
+
+/* Empties the ring and clears the drop counter. Call before the producer is armed. */
+void dl_rx_ring_reset(dl_rx_ring_t* r);
+
+/* Producer side (DMA): publishes 'n' bytes already written into 'buf' at head.
+ * Bytes overwritten before the consumer read them are counted as dropped, once each.
+ * The DMA writes up to half a ring ahead of its last event (half / full transfer), so the
+ * count is exact while the consumer stays within half a ring of the line. */
+void dl_rx_ring_commit(dl_rx_ring_t* r, uint16_t n);
+
+/* Consumer side: copies up to 'n' buffered bytes into 'dst'. Returns the number copied. */
+uint16_t dl_rx_ring_read(dl_rx_ring_t* r, uint8_t* dst, uint16_t n);
+
+/* Consumer side: discards everything currently buffered. */
+void dl_rx_ring_flush(dl_rx_ring_t* r);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DATALINK_RXRING_H */
@@ -0,0 +1,75 @@
+#include "DataLink_Trace.h"
+#include <string.h>
+
+#define DL_TRACE_MASK          (DL_TRACE_ENTRIES - 1u)
+
+/* Fixed-size slots: recording is one memcpy of at most DL_TRACE_SNAP bytes, and the
+ * oldest entry is dropped by the index wrap alone. */
+static dl_trace_entry_t s_trace[DL_TRACE_ENTRIES];
+static uint16_t         s_head;         /* next slot to write, runs freely */
+static uint16_t         s_count;
+static bool             s_on = true;
+
+void dl_trace_enable(bool on)
+{
+  s_on = on;
+}
+
+void dl_trace_clear(void)
+{
+  s_head  = 0u;
+  s_count = 0u;
+}
+
+void dl_trace_record(uint32_t t_us, uint8_t flags, const uint8_t* p, uint16_t n)
+{
+  dl_trace_entry_t* e;
+  uint8_t           cap;
+
+  if (!s_on)
+    return;
+
+  e   = &s_trace[s_head & DL_TRACE_MASK];
+  cap = (uint8_t)((n < DL_TRACE_SNAP) ? n : DL_TRACE_SNAP);
+
+  e->t_us  = t_us;
+  e->flags = flags;
+  e->len   = (uint8_t)((n > 0xFFu) ? 0xFFu : n);
+  e->cap   = cap;
+  e->rsvd  = 0u;
+  memcpy(e->data, p, cap);
+
+  s_head = (uint16_t)(s_head + 1u);
+  if (s_count < DL_TRACE_ENTRIES)
+    s_count++;
+}
+
+uint16_t dl_trace_count(void)
+{
+  return s_count;
+}
+
+static void put_le(uint8_t* p, uint32_t v, uint8_t n)
+{
+  for (uint8_t i = 0; i < n; ++i)
+    p[i] = (uint8_t)(v >> (8u * i));
+}
+
+void dl_trace_dump(uint32_t now_us, dl_trace_write_t write, void* ctx)
+{
+  uint8_t  hdr[DL_TRACE_HDR_SIZE];
+  uint16_t first = (uint16_t)(s_head - s_count);
+
+  memcpy(hdr, DL_TRACE_MAGIC, 4u);
+  hdr[4] = DL_TRACE_VERSION;
+  hdr[5] = (uint8_t)sizeof(dl_trace_entry_t);
+  hdr[6] = DL_TRACE_SNAP;
+  hdr[7] = 0u;
+  put_le(&hdr[8], s_count, 2u);
+  put_le(&hdr[10], now_us, 4u);
+  write(hdr, sizeof hdr, ctx);
+
+  /* entries go out in their in-memory layout: the board and the usual hosts are little-endian */
+  for (uint16_t i = 0; i < s_count; ++i)
+    write((const uint8_t*)&s_trace[(uint16_t)(first + i) & DL_TRACE_MASK], (uint16_t)sizeof(dl_trace_entry_t), ctx);
+}
@@ -0,0 +1,67 @@
+#ifndef DATALINK_TRACE_H
+#define DATALINK_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Trace ring sizing (entries must be a power of two) */
+#ifndef DL_TRACE_ENTRIES
+#define DL_TRACE_ENTRIES       32u								/* Frames kept; the oldest is overwritten. 32 x 32 B = 1 KB of RAM. */
+#endif
+#ifndef DL_TRACE_SNAP
+#define DL_TRACE_SNAP          24u								/* Leading frame bytes kept per entry: header, status, addr, size and the first data bytes. */
+#endif
+
+#if (DL_TRACE_ENTRIES & (DL_TRACE_ENTRIES - 1u)) != 0u
+#error "DL_TRACE_ENTRIES must be a power of two"
+#endif
+
+/* Entry flags */
+#define DL_TRACE_RX            0x01u							/* Frame received from the device (clear: sent by the host). */
+#define DL_TRACE_CRC_BAD       0x02u							/* Candidate response failed its CRC (a resync follows). */
+#define DL_TRACE_TIMEOUT       0x04u							/* Deadline hit: 'data' holds whatever had arrived. */
+#define DL_TRACE_REJECTED      0x08u							/* CRC-valid response rejected (status, address or size mismatch). */
+#define DL_TRACE_OVERRUN       0x10u							/* Receive overrun during the response: 'data' holds what survived. */
+
+/* Dump stream (dl_trace_dump), all fields little-endian:
+ *   header: "DLTR", version(1), entry size(1), snap(1), 0, count(2), dump time us(4)
+ *   then 'count' entries, oldest first, each laid out as dl_trace_entry_t. */
+#define DL_TRACE_MAGIC         "DLTR"
+#define DL_TRACE_VERSION       1u
+#define DL_TRACE_HDR_SIZE      14u
+
+/* One captured frame; 8 bytes + DL_TRACE_SNAP. */
+typedef struct {
+    uint32_t t_us;                /* link clock when the frame was sent / completed */
+    uint8_t  flags;               /* DL_TRACE_* */
+    uint8_t  len;                 /* bytes of the frame on the wire */
+    uint8_t  cap;                 /* bytes kept in 'data' (min(len, DL_TRACE_SNAP)) */
+    uint8_t  rsvd;
+    uint8_t  data[DL_TRACE_SNAP];
+} dl_trace_entry_t;
+
+/* Byte sink for dl_trace_dump, e.g. a UART transmit. */
+typedef void (*dl_trace_write_t)(const uint8_t* p, uint16_t n, void* ctx);
+
+/* Capture is on from reset; switching it off makes dl_trace_record a single test. */
+void     dl_trace_enable(bool on);
+void     dl_trace_clear(void);
+
+/* Appends one frame of 'n' bytes; only the first DL_TRACE_SNAP bytes of 'p' are read.
+ * Not ISR-safe: call from the context that runs the driver. */
+void     dl_trace_record(uint32_t t_us, uint8_t flags, const uint8_t* p, uint16_t n);
+
+uint16_t dl_trace_count(void);
+
+/* Streams the dump header and every entry, oldest first, to 'write'. 'now_us' (same clock
+ * as the entries) lets the decoder place the entries relative to the dump. */
+void     dl_trace_dump(uint32_t now_us, dl_trace_write_t write, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DATALINK_TRACE_H */
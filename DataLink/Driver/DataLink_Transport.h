@@ -0,0 +1,50 @@
+#ifndef DATALINK_TRANSPORT_H
+#define DATALINK_TRANSPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Byte transport under one DataLink link. The driver only talks to the line through
+ * these hooks, so the protocol code builds unchanged for the board (DataLink_TransportHal.c,
+ * STM32 HAL UART) and for a host (DataLink_TransportPosix.c, termios serial port / pty).
+ * 'ctx' is the backend's port object, as passed to dl_link_init(). */
+typedef struct {
+    /* Sends 'n' bytes; returns once they are handed to the line (or, with tx_busy, queued
+     * for it: 'p' may be reused at once). False on error. */
+    bool     (*send)(void* ctx, const uint8_t* p, uint16_t n);
+
+    /* Optional: true while bytes queued by send() are still going out. The driver starts
+     * its response deadline once this turns false. NULL when send() returns after the last
+     * byte has left. */
+    bool     (*tx_busy)(void* ctx);
+
+    /* Copies up to 'n' received bytes into 'dst'. If none are buffered, waits up to
+     * 'wait_ms' for some to arrive (0 = poll). Returns the number copied. */
+    uint16_t (*recv)(void* ctx, uint8_t* dst, uint16_t n, uint32_t wait_ms);
+
+    /* Optional: running count of receive overruns (UART overrun errors and receive buffer
+     * overflows). Any change means bytes are missing from the stream. NULL if the backend
+     * cannot tell. */
+    uint32_t (*rx_lost)(void* ctx);
+
+    /* Discards received bytes. With 'max_ms' > 0 it keeps discarding until the line has
+     * been quiet for DL_LINE_IDLE_CHARS character times, or 'max_ms' elapsed. */
+    void     (*flush)(void* ctx, uint32_t max_ms);
+
+    /* Free-running microsecond clock used for every deadline and latency on the link;
+     * wraps after ~71 minutes, so only differences are meaningful. */
+    uint32_t (*now_us)(void* ctx);
+} dl_transport_t;
+
+/* Platform microsecond clock behind the transports' now_us: SysTick plus the HAL tick on
+ * the board (DataLink_TransportHal.c), CLOCK_MONOTONIC on a host (DataLink_TransportPosix.c). */
+uint32_t dl_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DATALINK_TRANSPORT_H */
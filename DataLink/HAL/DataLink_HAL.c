@@ -1,18 +1,103 @@
-
-
 #include "DataLink_HAL.h"
-#include "main.h"      /* HAL_GetTick/HAL_Delay if needed later */
+#include "main.h"      /* HAL_GetTick, __get_PRIMASK / __set_PRIMASK, __disable_irq */
 #include <string.h>
 #include <stdio.h>
 
 /* CubeMX provides these in usart.c */
 extern UART_HandleTypeDef huart2;
 
+#define CONSOLE_TX_MASK        (CONSOLE_TX_SIZE - 1u)
+
+#if (CONSOLE_TX_SIZE & (CONSOLE_TX_SIZE - 1u)) != 0u
+#error "CONSOLE_TX_SIZE must be a power of two"
+#endif
+
+/* Console transmit ring: writers append and return, the USART2 Tx interrupt drains it one
+ * contiguous run at a time. 'head' is only written by writers, 'tail' and 'inflight' by
+ * the completion callback (or by a writer with interrupts masked). */
+static uint8_t           s_con_buf[CONSOLE_TX_SIZE];
+static volatile uint16_t s_con_head;        /* runs freely */
+static volatile uint16_t s_con_tail;
+static volatile uint16_t s_con_inflight;    /* bytes handed to HAL_UART_Transmit_IT */
+
+/* Starts the next run if the UART is idle. Interrupts masked or in the Tx callback. */
+static void console_kick(void)
+{
+    uint16_t off = (uint16_t)(s_con_tail & CONSOLE_TX_MASK);
+    uint16_t n   = (uint16_t)(s_con_head - s_con_tail);
+
+    if (s_con_inflight != 0u || n == 0u)
+        return;
+    if (n > CONSOLE_TX_SIZE - off)
+        n = (uint16_t)(CONSOLE_TX_SIZE - off);
+
+    s_con_inflight = n;
+    if (HAL_UART_Transmit_IT(&huart2, &s_con_buf[off], n) != HAL_OK)
+    {
+        s_con_tail     = (uint16_t)(s_con_tail + n);   /* drop it rather than stall the ring */
+        s_con_inflight = 0u;
+    }
+}
+
+void print_tx_cplt(UART_HandleTypeDef* huart)
+{
+    if (huart != &huart2)
+        return;
+
+    s_con_tail     = (uint16_t)(s_con_tail + s_con_inflight);
+    s_con_inflight = 0u;
+    console_kick();
+}
+
+/* Queues 'n' bytes for the console. Only waits while the ring is full; bytes still not
+ * accepted after CONSOLE_TX_TIMEOUT_MS without progress are dropped. */
+void print_bytes(const void* p, uint16_t n)
+{
+    const uint8_t* src  = (const uint8_t*)p;
+    uint16_t       tail = s_con_tail;
+    uint32_t       t0   = HAL_GetTick();
+
+    while (n != 0u)
+    {
+        uint16_t room = (uint16_t)(CONSOLE_TX_SIZE - (uint16_t)(s_con_head - s_con_tail));
+        uint16_t off  = (uint16_t)(s_con_head & CONSOLE_TX_MASK);
+        uint16_t k    = (n < room) ? n : room;
+        uint32_t primask;
+
+        if (k == 0u)
+        {
+            if (s_con_tail != tail)
+            {
+                tail = s_con_tail;
+                t0   = HAL_GetTick();
+            }
+            else if ((HAL_GetTick() - t0) >= CONSOLE_TX_TIMEOUT_MS)
+            {
+                return;
+            }
+            continue;
+        }
+        if (k > CONSOLE_TX_SIZE - off)
+            k = (uint16_t)(CONSOLE_TX_SIZE - off);
+
+        memcpy(&s_con_buf[off], src, k);
+        src += k;
+        n    = (uint16_t)(n - k);
+        s_con_head = (uint16_t)(s_con_head + k);
+
+        /* restore rather than re-enable: the caller may itself run with interrupts masked */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        console_kick();
+        __set_PRIMASK(primask);
+    }
+}
+
 /* Prints a raw line/string over the VCOM console (USART2) */
 void print_line(const char* s)
 {
     if (!s) return;
-    HAL_UART_Transmit(&huart2, (uint8_t*)s, (uint16_t)strlen(s), 100);
+    print_bytes(s, (uint16_t)strlen(s));
 }
 
 /* Formats and prints "Error 0xXXXXXXXX\r\n" over the VCOM console */
@@ -20,5 +105,5 @@ void print_error_hex(uint32_t err)
 {
     char line[32];
     int n = snprintf(line, sizeof line, "Error 0x%08lX\r\n", (unsigned long)err);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 }
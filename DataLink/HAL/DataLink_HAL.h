@@ -8,10 +8,24 @@
 extern "C" {
 #endif
 
-/* Console helpers (UART2) */
+/* Console transmit buffering (UART2, interrupt driven) */
+#ifndef CONSOLE_TX_SIZE
+#define CONSOLE_TX_SIZE        512u								/* Ring bytes (power of two); ~44 ms of output at 115200 baud. */
+#endif
+#ifndef CONSOLE_TX_TIMEOUT_MS
+#define CONSOLE_TX_TIMEOUT_MS  100u								/* Give up on a full ring that has not drained for this long. */
+#endif
+
+/* Console helpers (UART2). Output is queued and sent from the USART2 interrupt; the
+ * callers only wait when more than CONSOLE_TX_SIZE bytes are outstanding. */
+void print_bytes(const void* p, uint16_t n);
 void print_line(const char* s);
 void print_error_hex(uint32_t err);
 
+/* Tx-complete hook for the console UART; called from HAL_UART_TxCpltCallback
+ * (DataLink_TransportHal.c), which owns the HAL callback. */
+void print_tx_cplt(UART_HandleTypeDef* huart);
+
 #ifdef __cplusplus
 }
 #endif
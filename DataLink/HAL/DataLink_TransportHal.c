@@ -0,0 +1,260 @@
+#include "DataLink_TransportHal.h"
+#include "DataLink_Driver.h"   /* dl_link_init, DL_LINE_IDLE_CHARS, DL_MAX_LINKS */
+#include "DataLink_HAL.h"      /* print_tx_cplt: console transmit shares the Tx callback */
+#include "main.h"              /* HAL_GetTick, SysTick, SCB */
+#include <stddef.h>
+#include <string.h>
+
+/* Ports the HAL Rx callbacks dispatch to (by UART handle). */
+static dl_hal_port_t* s_ports[DL_MAX_LINKS];
+static uint8_t        s_port_count = 0u;
+
+/* USART1 port behind the default link. */
+static dl_hal_port_t  s_port_usart1;
+
+static dl_hal_port_t* port_of(const UART_HandleTypeDef* huart)
+{
+    for (uint8_t i = 0; i < s_port_count; ++i)
+    {
+        if (s_ports[i]->huart == huart)
+            return s_ports[i];
+    }
+    return NULL;
+}
+
+/* =============================================================================
+ * Receive path - circular ReceiveToIdle DMA fills a lock-free ring; each
+ * idle-line / half / full event publishes a whole burst (normally one frame)
+ * ===========================================================================*/
+/* Starts circular DMA reception into the ring. Call after the UART is initialised. */
+void dl_hal_port_start(dl_hal_port_t* port, UART_HandleTypeDef* huart)
+{
+    if (port_of(huart) == NULL && s_port_count < DL_MAX_LINKS)
+    {
+        s_ports[s_port_count++] = port;
+        port->tx_busy  = false;
+        port->overruns = 0u;
+    }
+    else
+    {
+        /* a restart: keep the ring's drops, so the count rx_lost reports never goes down */
+        port->overruns += port->rx.dropped;
+    }
+
+    port->huart = huart;
+    (void)HAL_UART_AbortReceive(huart);
+    dl_rx_ring_reset(&port->rx);
+    port->dma_pos = 0u;
+    __HAL_UART_CLEAR_FLAG(huart, UART_CLEAR_OREF | UART_CLEAR_NEF | UART_CLEAR_FEF | UART_CLEAR_PEF | UART_CLEAR_IDLEF);
+
+    /* receiver timeout: RTOF rises DL_LINE_IDLE_CHARS character times after the last stop bit */
+    HAL_UART_ReceiverTimeout_Config(huart, DL_LINE_IDLE_CHARS * 10u);
+    (void)HAL_UART_EnableReceiverTimeout(huart);
+    __HAL_UART_CLEAR_FLAG(huart, UART_CLEAR_RTOF);
+
+    (void)HAL_UARTEx_ReceiveToIdle_DMA(huart, port->rx.buf, DL_RX_RING_SIZE);
+}
+
+/* UART ISR hook: clear line errors before HAL_UART_IRQHandler sees them. HAL treats
+ * any error during DMA reception as blocking and would abort the circular transfer;
+ * a noisy byte is instead left for the frame CRC to reject. A pending receiver timeout
+ * counts as an error there too (and would skip the IDLE event), so it is cleared as well;
+ * it is only polled by hal_flush(). An overrun lost bytes outright: it is counted, and the
+ * driver fails the exchange in progress through the rx_lost hook. */
+void dl_hal_port_irq_handler(dl_hal_port_t* port)
+{
+    UART_HandleTypeDef* h   = port->huart;
+    uint32_t            isr = h->Instance->ISR;
+
+    if (isr & (USART_ISR_ORE | USART_ISR_NE | USART_ISR_FE | USART_ISR_PE | USART_ISR_RTOF))
+    {
+        if (isr & USART_ISR_ORE)
+            port->overruns++;
+        __HAL_UART_CLEAR_FLAG(h, UART_CLEAR_OREF | UART_CLEAR_NEF | UART_CLEAR_FEF | UART_CLEAR_PEF | UART_CLEAR_RTOF);
+    }
+}
+
+/* Default link on USART1: start reception and bind the link the first time. */
+void dl_rx_start(void)
+{
+    dl_hal_port_start(&s_port_usart1, &huart1);
+
+    if (dl_link_default()->tp == NULL)
+        (void)dl_link_init(dl_link_default(), &dl_transport_hal, &s_port_usart1);
+}
+
+void dl_rx_irq_handler(void)
+{
+    dl_hal_port_irq_handler(&s_port_usart1);
+}
+
+/* HAL Rx event (IDLE, half transfer, transfer complete): 'pos' is the DMA write offset
+ * within the ring buffer; publish everything received since the previous event. */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos)
+{
+    dl_hal_port_t* port = port_of(huart);
+    if (port == NULL)
+        return;
+
+    pos = (uint16_t)(pos & (DL_RX_RING_SIZE - 1u));
+    dl_rx_ring_commit(&port->rx, (uint16_t)((pos - port->dma_pos) & (DL_RX_RING_SIZE - 1u)));
+    port->dma_pos = pos;
+}
+
+/* Transmit complete (last stop bit out): the next frame may go, the response clock starts. */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    dl_hal_port_t* port = port_of(huart);
+
+    if (port != NULL)
+        port->tx_busy = false;
+    else
+        print_tx_cplt(huart);
+}
+
+/* Reception was aborted anyway (should not happen with the ISR hook): restart it. */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    dl_hal_port_t* port = port_of(huart);
+    if (port != NULL)
+    {
+        dl_hal_port_start(port, huart);
+    }
+}
+
+/* =============================================================================
+ * Transport hooks
+ * ===========================================================================*/
+/* Interrupt-driven transmit of a copy of the frame. Only a frame still going out from the
+ * previous send is waited for; its deadline covers a full buffer at the configured baud
+ * rate plus slack, after which the stuck transfer is aborted. */
+static bool hal_send(void* ctx, const uint8_t* p, uint16_t n)
+{
+    dl_hal_port_t* port = (dl_hal_port_t*)ctx;
+    uint32_t       ms   = (uint32_t)DL_HAL_TX_SIZE * 10u * 1000u / port->huart->Init.BaudRate + 10u;
+    uint32_t       t0   = HAL_GetTick();
+
+    if (n > DL_HAL_TX_SIZE)
+        return false;
+
+    while (port->tx_busy)
+    {
+        if ((HAL_GetTick() - t0) >= ms)
+        {
+            (void)HAL_UART_AbortTransmit(port->huart);
+            port->tx_busy = false;
+        }
+    }
+
+    memcpy(port->tx, p, n);
+    port->tx_busy = true;
+    if (HAL_UART_Transmit_IT(port->huart, port->tx, n) != HAL_OK)
+    {
+        port->tx_busy = false;
+        return false;
+    }
+    return true;
+}
+
+static bool hal_tx_busy(void* ctx)
+{
+    return ((dl_hal_port_t*)ctx)->tx_busy;
+}
+
+/* UART overruns plus bytes the circular DMA overwrote before the driver read them. */
+static uint32_t hal_rx_lost(void* ctx)
+{
+    dl_hal_port_t* port = (dl_hal_port_t*)ctx;
+    return port->overruns + port->rx.dropped;
+}
+
+static uint16_t hal_recv(void* ctx, uint8_t* dst, uint16_t n, uint32_t wait_ms)
+{
+    dl_hal_port_t* port = (dl_hal_port_t*)ctx;
+    uint32_t       t0   = HAL_GetTick();
+    uint16_t       got;
+
+    while ((got = dl_rx_ring_read(&port->rx, dst, n)) == 0u && n != 0u)
+    {
+        if ((HAL_GetTick() - t0) >= wait_ms)
+            break;
+    }
+    return got;
+}
+
+/* The receiver timeout measures the silence in hardware, but only starts after a received
+ * character; a line that is already quiet is recognised by the DMA counter not moving for
+ * the same time (rounded up to whole ticks). */
+static void hal_flush(void* ctx, uint32_t max_ms)
+{
+    dl_hal_port_t*      port    = (dl_hal_port_t*)ctx;
+    UART_HandleTypeDef* h       = port->huart;
+    uint32_t            t0      = HAL_GetTick();
+    uint32_t            quiet   = t0;
+    uint32_t            idle_ms = (DL_LINE_IDLE_CHARS * 10u * 1000u + h->Init.BaudRate - 1u) / h->Init.BaudRate + 1u;
+    uint32_t            ndtr    = __HAL_DMA_GET_COUNTER(h->hdmarx);
+
+    if (max_ms != 0u)
+        __HAL_UART_CLEAR_FLAG(h, UART_CLEAR_RTOF);
+
+    while ((HAL_GetTick() - t0) < max_ms)
+    {
+        uint32_t n = __HAL_DMA_GET_COUNTER(h->hdmarx);
+
+        if (n != ndtr)
+        {
+            ndtr  = n;
+            quiet = HAL_GetTick();
+        }
+
+        if (__HAL_UART_GET_FLAG(h, UART_FLAG_RTOF))
+        {
+            __HAL_UART_CLEAR_FLAG(h, UART_CLEAR_RTOF);
+            break;
+        }
+        if ((HAL_GetTick() - quiet) >= idle_ms)
+            break;
+    }
+
+    dl_rx_ring_flush(&port->rx);
+}
+
+static uint32_t hal_now_us(void* ctx)
+{
+    (void)ctx;
+    return dl_now_us();
+}
+
+const dl_transport_t dl_transport_hal = {
+    .send    = hal_send,
+    .tx_busy = hal_tx_busy,
+    .recv    = hal_recv,
+    .rx_lost = hal_rx_lost,
+    .flush   = hal_flush,
+    .now_us  = hal_now_us,
+};
+
+/* =============================================================================
+ * Microsecond clock - the HAL millisecond tick extended by the SysTick down-counter,
+ * so TIM2 stays free for the application. Assumes the default 1 kHz HAL tick.
+ * ===========================================================================*/
+uint32_t dl_now_us(void)
+{
+    uint32_t reload = SysTick->LOAD;
+    uint32_t ms, val;
+    bool     pend;
+
+    /* a tick ISR between the two reads would pair the old ms with a reloaded counter */
+    do {
+        ms   = HAL_GetTick();
+        val  = SysTick->VAL;
+        pend = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0u;
+    } while (ms != HAL_GetTick());
+
+    /* counter reloaded but the tick ISR could not run yet (called with it masked or from a
+     * higher-priority ISR): the millisecond it is about to count has already begun */
+    if (pend && val > (reload / 2u))
+        ms++;
+
+    return ms * 1000u + ((reload - val) * 1000u) / (reload + 1u);
+}
@@ -0,0 +1,44 @@
+#ifndef DATALINK_TRANSPORT_HAL_H
+#define DATALINK_TRANSPORT_HAL_H
+
+#include <stdint.h>
+#include "usart.h"              /* UART_HandleTypeDef */
+#include "DataLink_Transport.h"
+#include "DataLink_RxRing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DL_HAL_TX_SIZE
+#define DL_HAL_TX_SIZE         48u								/* Largest frame one send() takes; a full WRITE request is 7 + DL_MAX_WRITE bytes. */
+#endif
+
+/* One HAL UART used as a DataLink transport: circular ReceiveToIdle DMA feeds the ring,
+ * transmit is interrupt driven from a copy of the frame, so send() returns at once and the
+ * driver polls for the response while the frame is still going out. The UART needs its Rx
+ * DMA channel and IRQ configured (CubeMX). */
+typedef struct {
+    UART_HandleTypeDef* huart;
+    dl_rx_ring_t        rx;         /* circular DMA writes rx.buf directly */
+    uint16_t            dma_pos;    /* DMA write offset last published to the ring */
+    uint8_t             tx[DL_HAL_TX_SIZE];     /* frame being sent by HAL_UART_Transmit_IT */
+    volatile bool       tx_busy;    /* set by send, cleared by HAL_UART_TxCpltCallback */
+    volatile uint32_t   overruns;   /* UART overrun errors (receive FIFO full, DMA too late),
+                                     * plus ring drops carried over reception restarts */
+} dl_hal_port_t;
+
+extern const dl_transport_t dl_transport_hal;
+
+/* (Re)starts reception on 'huart' and registers the port for the HAL Rx callbacks.
+ * Pass the port to dl_link_init() together with &dl_transport_hal. */
+void dl_hal_port_start(dl_hal_port_t* port, UART_HandleTypeDef* huart);
+
+/* ISR hook: call from the UART's IRQ handler ahead of HAL_UART_IRQHandler. */
+void dl_hal_port_irq_handler(dl_hal_port_t* port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATALINK_TRANSPORT_HAL_H */
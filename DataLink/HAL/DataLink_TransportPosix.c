@@ -0,0 +1,175 @@
+/* Host transport - compiled only where termios exists; the firmware build skips it. */
+#if defined(__unix__) || defined(__APPLE__)
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE            /* cfmakeraw */
+
+#include "DataLink_TransportPosix.h"
+#include "DataLink_Driver.h"       /* DL_LINE_IDLE_CHARS */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+static speed_t posix_speed(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 9600u:   return B9600;
+        case 19200u:  return B19200;
+        case 38400u:  return B38400;
+        case 57600u:  return B57600;
+        case 115200u: return B115200;
+        default:      return B9600;
+    }
+}
+
+bool dl_posix_port_open(dl_posix_port_t* port, const char* path, uint32_t baud)
+{
+    struct termios t;
+
+    port->fd   = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    port->baud = baud;
+    if (port->fd < 0)
+        return false;
+
+    if (tcgetattr(port->fd, &t) != 0)
+    {
+        dl_posix_port_close(port);
+        return false;
+    }
+
+    cfmakeraw(&t);
+    t.c_cflag |= CLOCAL | CREAD;
+    t.c_cflag &= ~(tcflag_t)(CSTOPB | PARENB);
+    t.c_cc[VMIN]  = 0;
+    t.c_cc[VTIME] = 0;
+    (void)cfsetispeed(&t, posix_speed(baud));
+    (void)cfsetospeed(&t, posix_speed(baud));
+
+    if (tcsetattr(port->fd, TCSANOW, &t) != 0)
+    {
+        dl_posix_port_close(port);
+        return false;
+    }
+
+    (void)tcflush(port->fd, TCIOFLUSH);
+    return true;
+}
+
+void dl_posix_port_close(dl_posix_port_t* port)
+{
+    if (port->fd >= 0)
+        (void)close(port->fd);
+    port->fd = -1;
+}
+
+uint32_t dl_now_us(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+static uint32_t posix_now_us(void* ctx)
+{
+    (void)ctx;
+    return dl_now_us();
+}
+
+static uint32_t posix_now_ms(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+/* Waits up to 'ms' for 'events' on the port; true if ready. */
+static bool posix_wait(const dl_posix_port_t* port, short events, uint32_t ms)
+{
+    struct pollfd pfd = { port->fd, events, 0 };
+    int           r;
+
+    do {
+        r = poll(&pfd, 1, (int)ms);
+    } while (r < 0 && errno == EINTR);
+
+    return r > 0;
+}
+
+/* Queues the bytes in the kernel and returns without waiting for them to leave, so one
+ * thread can keep many ports busy. The measured RTT then includes the transmit time,
+ * which the adaptive deadlines absorb. */
+static bool posix_send(void* ctx, const uint8_t* p, uint16_t n)
+{
+    dl_posix_port_t* port = (dl_posix_port_t*)ctx;
+
+    while (n)
+    {
+        ssize_t w = write(port->fd, p, n);
+        if (w < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN || !posix_wait(port, POLLOUT, 100u))
+                return false;
+            continue;
+        }
+        p += w;
+        n  = (uint16_t)(n - (uint16_t)w);
+    }
+
+    return true;
+}
+
+static uint16_t posix_recv(void* ctx, uint8_t* dst, uint16_t n, uint32_t wait_ms)
+{
+    dl_posix_port_t* port = (dl_posix_port_t*)ctx;
+    ssize_t          r;
+
+    if (n == 0u)
+        return 0u;
+
+    r = read(port->fd, dst, n);
+    if (r <= 0 && wait_ms != 0u && posix_wait(port, POLLIN, wait_ms))
+        r = read(port->fd, dst, n);
+
+    return (r > 0) ? (uint16_t)r : 0u;
+}
+
+static void posix_flush(void* ctx, uint32_t max_ms)
+{
+    dl_posix_port_t* port    = (dl_posix_port_t*)ctx;
+    uint32_t         t0      = posix_now_ms();
+    uint32_t         idle_ms = (DL_LINE_IDLE_CHARS * 10u * 1000u + port->baud - 1u) / port->baud + 1u;
+    uint8_t          junk[64];
+
+    while (read(port->fd, junk, sizeof junk) > 0)
+    {
+    }
+
+    while (max_ms != 0u)
+    {
+        uint32_t waited = posix_now_ms() - t0;
+        if (waited >= max_ms)
+            break;
+        if (!posix_wait(port, POLLIN, (max_ms - waited < idle_ms) ? max_ms - waited : idle_ms))
+            break;                  /* quiet for a whole idle time */
+        while (read(port->fd, junk, sizeof junk) > 0)
+        {
+        }
+    }
+}
+
+const dl_transport_t dl_transport_posix = {
+    .send   = posix_send,
+    .recv   = posix_recv,
+    .flush  = posix_flush,
+    .now_us = posix_now_us,
+};
+
+#endif /* __unix__ || __APPLE__ */
@@ -0,0 +1,30 @@
+#ifndef DATALINK_TRANSPORT_POSIX_H
+#define DATALINK_TRANSPORT_POSIX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "DataLink_Transport.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Host build only: a serial port or pseudo-terminal as DataLink transport (termios, raw 8N1).
+ * Lets the driver and DataLink_User run on Linux against a real adapter or a simulated
+ * Ocean device on the other end of a pty. */
+typedef struct {
+    int      fd;
+    uint32_t baud;              /* sets the line-idle time; a pty ignores the rate itself */
+} dl_posix_port_t;
+
+extern const dl_transport_t dl_transport_posix;
+
+/* Opens 'path' (e.g. /dev/ttyUSB0, /dev/pts/N) raw at 'baud'. Returns false on error (errno set). */
+bool dl_posix_port_open(dl_posix_port_t* port, const char* path, uint32_t baud);
+void dl_posix_port_close(dl_posix_port_t* port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATALINK_TRANSPORT_POSIX_H */
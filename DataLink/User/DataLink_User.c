@@ -1,10 +1,9 @@
 #include "DataLink_User.h"
 #include "DataLink_Driver.h"   /* dl_read_retry / dl_write_retry, dl_status_t */
-#include "DataLink_HAL.h"
+#include "DataLink_HAL.h"       /* print_bytes for console prints (demo functions) */
 #include "Ocean_Registers.h"   /* OCEAN_* addresses/lengths/keys */
 #include "Ocean_Conversions.h" /* ocean_q14_2_to_volt / _q9_7_to_amp / _q2_6_to_watts_u16 */
 #include "main.h"              /* HAL_GetTick / HAL_Delay */
-#include "usart.h"             /* extern huart2 for console prints (demo functions) */
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
@@ -66,6 +65,29 @@ static bool ocean_unlock(void)
     }
 }
 
+/* Write-and-verify budgets. The fast one covers the brief pause a setpoint change may
+   cause (the read-back is retried through it) before the settle/handshake fallbacks. */
+#define OCEAN_VERIFY_FAST_MS   400u
+#define OCEAN_VERIFY_MS        DL_VERIFY_BUDGET_MS
+
+/* dl_write_verify() with one UNLOCK and a second attempt when the device refused the
+   WRITE itself (locked register). */
+static bool write_verify_unlocked(uint16_t addr, uint8_t len, const uint8_t *v, uint32_t budget_ms)
+{
+    dl_phase_t phase = DL_PHASE_NONE;
+
+    if (dl_write_verify(addr, len, v, budget_ms, &phase) == DL_OK)
+    {
+        return true;
+    }
+    if (phase != DL_PHASE_WRITE)
+    {
+        return false;
+    }
+    (void)ocean_unlock();
+    return (dl_write_verify(addr, len, v, budget_ms, NULL) == DL_OK);
+}
+
 // Channel configuration
 
 static bool read_channels_quick(uint8_t *out, uint32_t budget_ms)
@@ -75,9 +97,9 @@ static bool read_channels_quick(uint8_t *out, uint32_t budget_ms)
     while ((HAL_GetTick() - t0) < budget_ms)
     {
         uint8_t b[12]; // Device Info block
-        // Short, non-retry read (50/80 ms): avoids long backoffs
+        // Short, non-retry read (adaptive deadlines): avoids long backoffs
         dl_status_t st = dl_read(/*addr*/0x0008u, /*len*/12u, b,
-                                 /*hdr*/50u, /*pay*/80u);
+                                 /*hdr*/DL_WAIT_AUTO, /*pay*/DL_WAIT_AUTO);
         if (st == DL_OK) { *out = b[0]; return true; }
         HAL_Delay(20u);
     }
@@ -93,7 +115,7 @@ bool SetChannels(uint8_t nc)
     }
 
     // --- Send write with short waits; do NOT use *_retry here ---
-    (void)dl_write(/*addr*/0x8109u, /*len*/1u, &nc, /*hdr*/30u, /*pay*/30u);
+    (void)dl_write(/*addr*/0x8109u, /*len*/1u, &nc, /*hdr*/DL_WAIT_AUTO, /*pay*/DL_WAIT_AUTO);
 
     // Device reconfigures; give it a brief settle
     HAL_Delay(120u);
@@ -116,7 +138,7 @@ bool SetChannels(uint8_t nc)
 
     // --- One UNLOCK + one more short write, quick re-sync, verify ---
     (void)ocean_unlock();
-    (void)dl_write(0x8109u, 1u, &nc, 30u, 30u);
+    (void)dl_write(0x8109u, 1u, &nc, DL_WAIT_AUTO, DL_WAIT_AUTO);
     HAL_Delay(120u);
     (void)dl_handshake_quick(3, 3, 25u, 80u);
 
@@ -167,7 +189,7 @@ static bool read_setpoint_quick(uint8_t *out, uint32_t budget_ms)
     while ((HAL_GetTick() - t0) < budget_ms) {
         uint8_t rb = 0xFF;
         dl_status_t st = dl_read(/*0x8108*/0x8108u, /*len*/1u, &rb,
-                                 /*hdr*/40u, /*pay*/60u);
+                                 /*hdr*/DL_WAIT_AUTO, /*pay*/DL_WAIT_AUTO);
         if (st == DL_OK) { *out = rb; return true; }
         HAL_Delay(20u);
     }
@@ -181,7 +203,7 @@ static bool read_power_quick(uint16_t *out_q26, uint32_t budget_ms)
     while ((HAL_GetTick() - t0) < budget_ms) {
         uint8_t b[2] = {0};
         dl_status_t st = dl_read(/*0x000A*/0x000Au, /*len*/2u, b,
-                                 /*hdr*/40u, /*pay*/60u);
+                                 /*hdr*/DL_WAIT_AUTO, /*pay*/DL_WAIT_AUTO);
         if (st == DL_OK) {
             *out_q26 = (uint16_t)b[0] | ((uint16_t)b[1] << 8);
             return true;
@@ -201,8 +223,14 @@ bool SetPower(float pow)
         return true;
     }
 
+    // --- Fast path: unlock, write + pipelined read-back under one short deadline ---
+    (void)ocean_unlock();
+    if (dl_write_verify(0x8108u, 1u, &q26, OCEAN_VERIFY_FAST_MS, NULL) == DL_OK) {
+        return true;
+    }
+
     // --- Fire write with short waits (no retry) ---
-    (void)dl_write(/*addr*/0x8108u, /*len*/1u, &q26, /*hdr*/30u, /*pay*/30u);
+    (void)dl_write(/*addr*/0x8108u, /*len*/1u, &q26, /*hdr*/DL_WAIT_AUTO, /*pay*/DL_WAIT_AUTO);
     HAL_Delay(120u);                  // device may reconfigure briefly
     (void)dl_handshake_quick(3,3,25u,80u);  // quick re-sync
 
@@ -225,7 +253,7 @@ bool SetPower(float pow)
 
     // --- One UNLOCK + one more short write, quick re-sync, verify again ---
     (void)ocean_unlock();
-    (void)dl_write(0x8108u, 1u, &q26, 30u, 30u);
+    (void)dl_write(0x8108u, 1u, &q26, DL_WAIT_AUTO, DL_WAIT_AUTO);
     HAL_Delay(120u);
     (void)dl_handshake_quick(3,3,25u,80u);
 
@@ -257,6 +285,50 @@ bool SetPower(float pow)
     return false;
 }
 
+static bool read_setpoints_quick(uint8_t out[2], uint32_t budget_ms)
+{
+    if (!out) return false;
+    uint32_t t0 = HAL_GetTick();
+    while ((HAL_GetTick() - t0) < budget_ms) {
+        uint8_t b[2] = {0xFF, 0xFF};
+        dl_status_t st = dl_read(/*0x8108*/0x8108u, /*len*/2u, b,
+                                 /*hdr*/DL_WAIT_AUTO, /*pay*/DL_WAIT_AUTO);
+        if (st == DL_OK) { out[0] = b[0]; out[1] = b[1]; return true; }
+        HAL_Delay(20u);
+    }
+    return false;
+}
+
+/* Power setpoint (0x8108) and NUM_CHANNELS (0x8109) are adjacent, so both go out as one
+   WRITE frame after a single unlock, and one 2-byte read verifies them together. */
+bool SetConfig(uint8_t nc, float pow)
+{
+    uint8_t q26 = encode_q26_u8(pow);
+    uint8_t rb[2];
+    const uint8_t v[2] = { q26, nc };
+
+    // --- Early exit if already set (quick) ---
+    if (read_setpoints_quick(rb, /*budget_ms*/120u) && rb[0] == q26 && rb[1] == nc) {
+        return true;
+    }
+
+    // --- One UNLOCK + one 2-byte write with its read-back pipelined behind it ---
+    (void)ocean_unlock();
+    if (dl_write_verify(0x8108u, 2u, v, OCEAN_VERIFY_FAST_MS, NULL) == DL_OK) {
+        return true;
+    }
+    HAL_Delay(120u);                  // device may reconfigure briefly
+    (void)dl_handshake_quick(3,3,25u,80u);  // quick re-sync
+
+    // --- One verify read covering both registers ---
+    if (read_setpoints_quick(rb, /*budget_ms*/300u) && rb[0] == q26 && rb[1] == nc) {
+        return true;
+    }
+
+    // --- Fallback: the per-register sequences with their own recovery ---
+    return SetPower(pow) && SetChannels(nc);
+}
+
 bool ChangePower(float pow)
 {
     /* --- encode Q2.6 (U8 at 0x8108) --- */
@@ -274,7 +346,7 @@ bool ChangePower(float pow)
     /* Force OFF */
     {
         uint8_t off = 0u;
-        (void)dl_write_retry(0x800Cu, 1u, &off);
+        if (dl_write_verify(0x800Cu, 1u, &off, OCEAN_VERIFY_MS, NULL) != DL_OK)
         {
             uint32_t t0 = HAL_GetTick();
             for (;;)
@@ -293,28 +365,15 @@ bool ChangePower(float pow)
         }
     }
 
-    /* Unlock and write setpoint (1 byte @ 0x8108) */
+    /* Unlock and write setpoint (1 byte @ 0x8108), read-back verified */
     (void)ocean_unlock();
     {
-        dl_status_t wr = dl_write_retry(0x8108u, 1u, &q26);
-        bool ok = false;
-
-        if (wr == DL_OK)
-        {
-            uint8_t rb = 0xFF;
-            if (dl_read_retry(0x8108u, 1u, &rb) == DL_OK)
-            {
-                if (rb == q26)
-                {
-                    ok = true;
-                }
-            }
-        }
+        bool ok = (dl_write_verify(0x8108u, 1u, &q26, OCEAN_VERIFY_MS, NULL) == DL_OK);
 
         /* Turn ON again */
         {
             uint8_t on = 1u;
-            (void)dl_write_retry(0x800Cu, 1u, &on);
+            if (dl_write_verify(0x800Cu, 1u, &on, OCEAN_VERIFY_MS, NULL) != DL_OK)
             {
                 uint32_t t1 = HAL_GetTick();
                 for (;;)
@@ -359,6 +418,33 @@ bool ReadPower(float *watts)
     return true;
 }
 
+/* Reads Active channels (U8 @ 0x0008) and the channel power report (Q2.6 U16 @ 0x000A)
+   as one batched read: both sit in the Device Info block, so a single frame covers them. */
+bool ReadConfig(uint8_t *num_channels, float *watts)
+{
+    uint8_t ch = 0u;
+    uint8_t p[2];
+    const dl_read_req_t reqs[] =
+    {
+        { 0x0008u, 1u, &ch },
+        { 0x000Au, 2u, p   },
+    };
+
+    if ((num_channels == NULL) || (watts == NULL))
+    {
+        return false;
+    }
+
+    if (dl_read_batch(reqs, (uint8_t)(sizeof(reqs) / sizeof(reqs[0]))) != DL_OK)
+    {
+        return false;
+    }
+
+    *num_channels = ch;
+    *watts = ocean_q2_6_to_watts_u16((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+    return true;
+}
+
 // Output control
 /* Writes OUTPUT_STATE @0x800C (exactly 1 byte, 0 or 1). Verifies read-back. */
 bool WriteOutputState(uint8_t state)
@@ -372,27 +458,8 @@ bool WriteOutputState(uint8_t state)
 	    state = 0u;
 	}
 
-	dl_status_t st = dl_write_retry(0x800Cu, 1, &state);
-
-	if (st != DL_OK)
-	{
-		/* unlock once, then retry */
-		uint8_t keys[8];
-		le32_to_buf(&keys[0], OCEAN_UNLOCK_KEY0);
-		le32_to_buf(&keys[4], OCEAN_UNLOCK_KEY1);
-		(void)dl_write_retry(0x8100u, 8, keys);
-		st = dl_write_retry(0x800Cu, 1, &state);
-
-		if (st != DL_OK)
-			return false;
-	}
-
-	/* read-back verify */
-	uint8_t rb = 0xFF;
-	if (dl_read_retry(0x800Cu, 1, &rb) != DL_OK)
-		return false;
-
-	return (rb == state);
+	/* write + read-back verify; unlock once if the write is refused */
+	return write_verify_unlocked(0x800Cu, 1u, &state, OCEAN_VERIFY_MS);
 }
 
 /* Reads OUTPUT_STATE @ 0x800C (U8). Returns true on success and sets *state. */
@@ -418,33 +485,9 @@ bool ReadOutputState(uint8_t *state)
 bool WriteDefaultState(uint8_t state)
 {
     uint8_t v = (state != 0u) ? 1u : 0u;
-    dl_status_t st = dl_write_retry(0x800Eu, 1u, &v);
 
-    if (st != DL_OK)
-    {
-        /* unlock once, then retry */
-        (void)ocean_unlock();
-        st = dl_write_retry(0x800Eu, 1u, &v);
-        if (st != DL_OK)
-        {
-            return false;
-        }
-    }
-
-    /* read-back verify */
-    {
-        uint8_t rb = 0xFFu;
-        if (dl_read_retry(0x800Eu, 1u, &rb) != DL_OK)
-        {
-            return false;
-        }
-        if (rb != v)
-        {
-            return false;
-        }
-    }
-
-    return true;
+    /* write + read-back verify; unlock once if the write is refused */
+    return write_verify_unlocked(0x800Eu, 1u, &v, OCEAN_VERIFY_MS);
 }
 
 /* Reads DEFAULT_OUTPUT_STATE @ 0x800E (U8) */
@@ -551,31 +594,31 @@ bool ReadData(void)
     int n;
 
     n = snprintf(line, sizeof line, "Output voltage: %.2f V\r\n", (double)out_v);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 1 voltage: %.2f V\r\n", (double)ch1_v);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 1 current: %.3f A\r\n", (double)ch1_i);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 2 voltage: %.2f V\r\n", (double)ch2_v);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 2 current: %.3f A\r\n", (double)ch2_i);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 3 voltage: %.2f V\r\n", (double)ch3_v);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 3 current: %.3f A\r\n", (double)ch3_i);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 4 voltage: %.2f V\r\n", (double)ch4_v);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     n = snprintf(line, sizeof line, "Channel 4 current: %.3f A\r\n", (double)ch4_i);
-    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+    print_bytes(line, (uint16_t)n);
 
     return true;
 }
@@ -594,7 +637,7 @@ void read_and_print_serial(void)
         {
             char line[64];
             int n = snprintf(line, sizeof line, "Serial number: 0x%08lX\r\n", (unsigned long)serial);
-            HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+            print_bytes(line, (uint16_t)n);
         }
     }
 }
@@ -612,18 +655,40 @@ void read_and_print_accum_on_time(void)
         {
             char line[64];
             int n = snprintf(line, sizeof line, "Accumulated on time: %lu\r\n", (unsigned long)ontime);
-            HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+            print_bytes(line, (uint16_t)n);
         }
     }
 }
 
 void read_one_time_blocks(void)
 {
-    uint8_t buf[64];
+    uint8_t buf[OCEAN_LEN_DEVICE_INFO];
+    uint8_t sblk[OCEAN_LEN_STATUS];
+    /* Status (0x0000) and Device Info (0x0008) are adjacent: one batched frame reads both */
+    const dl_read_req_t reqs[] =
+    {
+        { OCEAN_ADDR_DEVICE_INFO, OCEAN_LEN_DEVICE_INFO, buf  },
+        { OCEAN_ADDR_STATUS,      OCEAN_LEN_STATUS,      sblk },
+    };
+    bool info_ok;
+    bool status_ok;
+
+    if (dl_read_batch(reqs, (uint8_t)(sizeof(reqs) / sizeof(reqs[0]))) == DL_OK)
+    {
+        info_ok = true;
+        status_ok = true;
+    }
+    else
+    {
+        /* The 20-byte frame failed every retry: fall back to one smaller read per block,
+           so a link that only carries short frames still gets what it can. */
+        info_ok = (dl_read_retry(OCEAN_ADDR_DEVICE_INFO, OCEAN_LEN_DEVICE_INFO, buf) == DL_OK);
+        status_ok = (dl_read_retry(OCEAN_ADDR_STATUS, OCEAN_LEN_STATUS, sblk) == DL_OK);
+    }
 
-    /* Device Information: 0x0008 (12B): ActiveCh(U8), ChPower(Q2.6 U16), FW(U32), PID(U32) */
-    if (dl_read_retry(OCEAN_ADDR_DEVICE_INFO, OCEAN_LEN_DEVICE_INFO, buf) == DL_OK)
+    if (info_ok)
     {
+        /* Device Information: 0x0008 (12B): ActiveCh(U8), ChPower(Q2.6 U16), FW(U32), PID(U32) */
         g_active_channels = buf[0]; /* Active channels */
         {
             uint16_t chp_raw = (uint16_t)buf[2] | ((uint16_t)buf[3] << 8);
@@ -642,23 +707,23 @@ void read_one_time_blocks(void)
         {
             char line[160];
             int n = snprintf(line, sizeof line, "Active channels: %u\r\n", (unsigned)g_active_channels);
-            HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+            print_bytes(line, (uint16_t)n);
             n = snprintf(line, sizeof line, "Firmware: 0x%08lX\r\n", (unsigned long)g_firmware_version);
-            HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+            print_bytes(line, (uint16_t)n);
             n = snprintf(line, sizeof line, "Product ID: 0x%08lX\r\n", (unsigned long)g_product_id);
-            HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+            print_bytes(line, (uint16_t)n);
             n = snprintf(line, sizeof line, "Channel power: %.3f\r\n", (double)g_channel_power);
-            HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+            print_bytes(line, (uint16_t)n);
         }
     }
 
     /* Status + ErrorFlags once at startup; print only "Error 0xXXXXXXXX" */
-    if (dl_read_retry(OCEAN_ADDR_STATUS, OCEAN_LEN_STATUS, buf) == DL_OK)
+    if (status_ok)
     {
-        uint32_t err = (uint32_t)buf[4]
-                     | ((uint32_t)buf[5] << 8)
-                     | ((uint32_t)buf[6] << 16)
-                     | ((uint32_t)buf[7] << 24);
+        uint32_t err = (uint32_t)sblk[4]
+                     | ((uint32_t)sblk[5] << 8)
+                     | ((uint32_t)sblk[6] << 16)
+                     | ((uint32_t)sblk[7] << 24);
         print_error_hex(err);
     }
 
@@ -688,13 +753,13 @@ void poll_periodic(void)
                 {
                     float v = ocean_q14_2_to_volt(raw);
                     int n = snprintf(line, sizeof line, "%s: %.2f V\r\n", k_meas_sel[i].name, (double)v);
-                    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+                    print_bytes(line, (uint16_t)n);
                 }
                 else
                 {
                     float a = ocean_q9_7_to_amp(raw);
                     int n = snprintf(line, sizeof line, "%s: %.3f A\r\n", k_meas_sel[i].name, (double)a);
-                    HAL_UART_Transmit(&huart2, (uint8_t*)line, (uint16_t)n, 100);
+                    print_bytes(line, (uint16_t)n);
                 }
             }
         }
@@ -13,6 +13,8 @@ bool ReadChannels(uint8_t *out_channels);	/* Reads from 0x0008 block */
 bool SetPower(float watts);                 /* valid: 0.5 .. 1.0 */
 bool ChangePower (float watts);				/* valid: 0.5 .. 1.0 */
 bool ReadPower(float *out_value);
+bool ReadConfig(uint8_t *out_channels, float *out_value);	/* Active channels + power report in one frame */
+bool SetConfig(uint8_t channels, float watts);			/* Power + NUM_CHANNELS in one unlock/write/verify */
 
 /* Output and default states */
 bool WriteOutputState(uint8_t state);       /* valid: 0 or 1 */
@@ -0,0 +1,133 @@
+/* crc_bench - host micro-benchmark of the DataLink CRC16 kernel (DataLink_Crc.c).
+ *
+ * Times the kernel selected by DL_CRC_KERNEL on full 96-byte frames (DL_MAX_FRAME) two
+ * ways: crc16_compute() over the whole frame (TX side, where the slicing kernels apply) and
+ * crc16_update() byte by byte (RX side, always one byte per step). Each figure is the best of
+ * several runs; output is one CSV row: kernel, then cycles/byte and ns/byte for each path.
+ * Cycles are TSC ticks (x86 only, "n/a" elsewhere) - they count at the nominal clock, so
+ * compare kernels against each other on one machine rather than against target cycles.
+ *
+ * Tools/crc_bench/crc_bench.sh builds it once per kernel and adds the flash/RAM each kernel
+ * costs (size of DataLink_Crc.o, optionally cross-compiled for the target). One kernel by hand:
+ *   gcc -O2 -std=gnu11 -Wall -Wextra -DDL_CRC_KERNEL=0 -IDataLink/Driver -o crc_bench \
+ *       Tools/crc_bench/crc_bench.c DataLink/Driver/DataLink_Crc.c && ./crc_bench
+ */
+#define _GNU_SOURCE
+
+#include "DataLink_Crc.h"
+#include "DataLink_Driver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC         1
+#else
+#define BENCH_HAVE_TSC         0
+#endif
+
+#define BENCH_FRAMES           64u      /* distinct random frames, cycled through */
+#define BENCH_PASSES           4000u    /* frames per run = BENCH_FRAMES * BENCH_PASSES */
+#define BENCH_RUNS             5u       /* best of */
+
+static const char* const k_kernel_name[] = { "BYTE", "NIBBLE", "SLICE2", "SLICE4" };
+
+static uint8_t           s_frames[BENCH_FRAMES][DL_MAX_FRAME];
+static volatile uint16_t s_sink;
+
+typedef struct {
+    double cycles;
+    double ns;
+} bench_t;
+
+static uint64_t ticks(void)
+{
+#if BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0u;
+#endif
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+static uint16_t run_compute(void)
+{
+    uint16_t acc = 0u;
+
+    for (unsigned p = 0; p < BENCH_PASSES; ++p)
+        for (unsigned f = 0; f < BENCH_FRAMES; ++f)
+            acc ^= crc16_compute(s_frames[f], DL_MAX_FRAME, CRC16_INIT);
+    return acc;
+}
+
+static uint16_t run_update(void)
+{
+    uint16_t acc = 0u;
+
+    for (unsigned p = 0; p < BENCH_PASSES; ++p)
+    {
+        for (unsigned f = 0; f < BENCH_FRAMES; ++f)
+        {
+            crc16_ctx_t ctx;
+
+            crc16_start(&ctx);
+            for (unsigned i = 0; i < DL_MAX_FRAME; ++i)
+                crc16_update(&ctx, s_frames[f][i]);
+            acc ^= ctx.crc;
+        }
+    }
+    return acc;
+}
+
+/* Best of BENCH_RUNS, per byte. */
+static bench_t measure(uint16_t (*run)(void))
+{
+    const double bytes = (double)BENCH_PASSES * BENCH_FRAMES * DL_MAX_FRAME;
+    bench_t      best  = { 0.0, 0.0 };
+
+    for (unsigned r = 0; r < BENCH_RUNS; ++r)
+    {
+        uint64_t t0 = now_ns(), c0 = ticks();
+        s_sink ^= run();
+        uint64_t c1 = ticks(), t1 = now_ns();
+        bench_t  b  = { (double)(c1 - c0) / bytes, (double)(t1 - t0) / bytes };
+
+        if (r == 0u || b.ns < best.ns)
+            best = b;
+    }
+    return best;
+}
+
+static void print_cycles(double c)
+{
+    if (BENCH_HAVE_TSC)
+        printf("%.2f", c);
+    else
+        printf("n/a");
+}
+
+int main(void)
+{
+    bench_t compute, update;
+
+    srand(1u);
+    for (unsigned f = 0; f < BENCH_FRAMES; ++f)
+        for (unsigned i = 0; i < DL_MAX_FRAME; ++i)
+            s_frames[f][i] = (uint8_t)rand();
+
+    compute = measure(run_compute);
+    update  = measure(run_update);
+
+    printf("%s,", k_kernel_name[DL_CRC_KERNEL]);
+    print_cycles(compute.cycles);
+    printf(",%.3f,", compute.ns);
+    print_cycles(update.cycles);
+    printf(",%.3f\n", update.ns);
+    return 0;
+}
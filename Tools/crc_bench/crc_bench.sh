@@ -0,0 +1,30 @@
+#!/bin/sh
+# CRC kernel benchmark: one CSV row per DL_CRC_KERNEL with the flash and RAM the kernel costs
+# (text and data+bss of DataLink_Crc.o) and its speed on this host (see crc_bench.c).
+# Sizes are for the host compiler unless CROSS names a target toolchain prefix, e.g.
+#   CROSS=arm-none-eabi- Tools/crc_bench/crc_bench.sh     (Cortex-M0+ flags, -Os)
+# Usage: Tools/crc_bench/crc_bench.sh   (run from the repository root)
+set -e
+
+OUT=${BENCH_DIR:-/tmp/dl_crc_bench}
+CC=${CC:-gcc}
+CROSS=${CROSS:-}
+if [ -n "$CROSS" ]; then
+    TARGET_CFLAGS=${TARGET_CFLAGS:-"-Os -mcpu=cortex-m0plus -mthumb -ffunction-sections -fdata-sections"}
+else
+    TARGET_CFLAGS=${TARGET_CFLAGS:-"-Os"}
+fi
+
+mkdir -p "$OUT"
+echo "kernel,flash_B,ram_B,compute_cycles_per_byte,compute_ns_per_byte,update_cycles_per_byte,update_ns_per_byte"
+for k in 0 1 2 3; do
+    ${CROSS}gcc -std=gnu11 $TARGET_CFLAGS -DDL_CRC_KERNEL=$k -IDataLink/Driver -c -o "$OUT/crc$k.o" \
+        DataLink/Driver/DataLink_Crc.c
+    set -- $(${CROSS}size "$OUT/crc$k.o" | tail -n 1)
+    flash=$(( $1 + $2 ))    # code + tables, plus initialised data copied from flash
+    ram=$(( $2 + $3 ))
+
+    $CC -O2 -std=gnu11 -Wall -Wextra -DDL_CRC_KERNEL=$k -IDataLink/Driver -o "$OUT/crc_bench$k" \
+        Tools/crc_bench/crc_bench.c DataLink/Driver/DataLink_Crc.c
+    "$OUT/crc_bench$k" | sed "s/^\([^,]*\),/\1,$flash,$ram,/"
+done
@@ -0,0 +1,309 @@
+/* dl_host - drives many Ocean devices from one Linux host with the firmware's DataLink driver.
+ *
+ * Every serial port becomes one dl_link_t on the POSIX transport. Each worker thread owns a
+ * share of the links and one epoll set: it sleeps until a port has input or the nearest
+ * transaction deadline (dl_link_poll_timeout) expires, then steps only those links. Every
+ * link keeps one READ in flight and re-queues it from the completion callback; at the end
+ * the tool prints aggregate transactions per second and latency percentiles.
+ *
+ * Build (from the repository root):
+ *   gcc -O2 -std=gnu11 -pthread -DDL_MAX_LINKS=1024 \
+ *       -IDataLink/Driver -IDataLink/HAL -o dl_host Tools/dl_host/dl_host.c \
+ *       DataLink/Driver/DataLink_Driver.c DataLink/Driver/DataLink_Crc.c \
+ *       DataLink/Driver/DataLink_Trace.c DataLink/HAL/DataLink_TransportPosix.c
+ *
+ * Usage: dl_host [-t threads] [-d seconds] [-a addr] [-l len] [-s] port...
+ *   -s skips the reset handshake at start-up.
+ */
+#define _GNU_SOURCE
+
+#include "DataLink_Driver.h"
+#include "DataLink_TransportPosix.h"
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HOST_POLL_CAP_MS   100u     /* upper bound on one epoll_wait, keeps the end check responsive */
+#define HOST_POLL_STEPS    4u       /* dl_link_poll calls per readable port: header, body, completion, next submit */
+
+typedef struct {
+    dl_link_t       link;
+    dl_posix_port_t port;
+    uint8_t         buf[DL_MAX_READ];
+    uint64_t        t_submit_us;
+    struct worker*  w;
+} host_link_t;
+
+typedef struct worker {
+    pthread_t     thread;
+    host_link_t** links;
+    unsigned      count;
+    uint64_t      ok;
+    uint64_t      failed;
+    uint32_t*     lat_us;           /* one sample per completed transaction */
+    size_t        lat_n;
+    size_t        lat_cap;
+} worker_t;
+
+static uint16_t s_addr = 0x0100u;   /* OCEAN measurement block */
+static uint8_t  s_len  = 8u;
+static uint64_t s_end_us;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void on_done(dl_status_t st, void* ctx);
+
+static void submit(host_link_t* h)
+{
+    h->t_submit_us = now_us();
+    if (dl_link_read_async(&h->link, s_addr, s_len, h->buf, on_done, h) != DL_OK)
+        h->w->failed++;
+}
+
+/* Completion: record the latency and keep one transaction in flight until the end. */
+static void on_done(dl_status_t st, void* ctx)
+{
+    host_link_t* h = (host_link_t*)ctx;
+    worker_t*    w = h->w;
+    uint64_t     t = now_us();
+
+    if (st == DL_OK)
+    {
+        w->ok++;
+        if (w->lat_n == w->lat_cap)
+        {
+            w->lat_cap = w->lat_cap ? w->lat_cap * 2u : 4096u;
+            w->lat_us  = realloc(w->lat_us, w->lat_cap * sizeof *w->lat_us);
+            if (w->lat_us == NULL)
+            {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        w->lat_us[w->lat_n++] = (uint32_t)(t - h->t_submit_us);
+    }
+    else
+    {
+        w->failed++;
+    }
+
+    if (t < s_end_us)
+        submit(h);
+}
+
+static void* worker_main(void* arg)
+{
+    worker_t*          w  = (worker_t*)arg;
+    int                ep = epoll_create1(0);
+    struct epoll_event ev[64];
+
+    if (ep < 0)
+    {
+        perror("epoll_create1");
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < w->count; ++i)
+    {
+        struct epoll_event e = { .events = EPOLLIN, .data.ptr = w->links[i] };
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, w->links[i]->port.fd, &e) != 0)
+            perror("epoll_ctl");
+        submit(w->links[i]);
+    }
+
+    for (;;)
+    {
+        uint32_t wait_ms = HOST_POLL_CAP_MS;
+        bool     busy    = false;
+
+        for (unsigned i = 0; i < w->count; ++i)
+        {
+            uint32_t t = dl_link_poll_timeout(&w->links[i]->link);
+            if (t != DL_POLL_NO_DEADLINE)
+                busy = true;
+            if (t < wait_ms)
+                wait_ms = t;
+        }
+        if (!busy && now_us() >= s_end_us)
+            break;
+
+        int n = epoll_wait(ep, ev, (int)(sizeof ev / sizeof ev[0]), (int)wait_ms);
+        if (n < 0 && errno != EINTR)
+        {
+            perror("epoll_wait");
+            break;
+        }
+
+        /* ports with input: step while the link still has work, up to one step per stage */
+        for (int i = 0; i < n; ++i)
+        {
+            host_link_t* h = (host_link_t*)ev[i].data.ptr;
+            for (unsigned k = 0; k < HOST_POLL_STEPS && dl_link_poll(&h->link); ++k)
+                ;
+        }
+
+        /* links whose deadline expired or that have a request waiting to go out */
+        for (unsigned i = 0; i < w->count; ++i)
+        {
+            if (dl_link_poll_timeout(&w->links[i]->link) == 0u)
+                (void)dl_link_poll(&w->links[i]->link);
+        }
+    }
+
+    close(ep);
+    return NULL;
+}
+
+static int cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Parses the whole of 's' as a number in min..max (decimal, 0x hex or 0 octal); false
+ * with a message naming option 'opt' otherwise. Checked before any narrowing. */
+static bool parse_num(char opt, const char* s, unsigned long min, unsigned long max, unsigned long* out)
+{
+    char* end;
+
+    errno = 0;
+    *out  = strtoul(s, &end, 0);
+    if (*s == '\0' || *s == '-' || *end != '\0' || errno != 0 || *out < min || *out > max)
+    {
+        fprintf(stderr, "-%c %s: expected %lu..%lu\n", opt, s, min, max);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned      threads = 1u, seconds = 5u;
+    bool          handshake = true;
+    unsigned long v;
+    int           opt;
+
+    while ((opt = getopt(argc, argv, "t:d:a:l:s")) != -1)
+    {
+        switch (opt)
+        {
+            case 't':
+                if (!parse_num('t', optarg, 1u, DL_MAX_LINKS, &v))
+                    return 2;
+                threads = (unsigned)v;
+                break;
+            case 'd':
+                if (!parse_num('d', optarg, 0u, UINT_MAX, &v))
+                    return 2;
+                seconds = (unsigned)v;
+                break;
+            case 'a':
+                if (!parse_num('a', optarg, 0u, 0xFFFFu, &v))
+                    return 2;
+                s_addr = (uint16_t)v;
+                break;
+            case 'l':
+                if (!parse_num('l', optarg, 1u, DL_MAX_READ, &v))
+                    return 2;
+                s_len = (uint8_t)v;
+                break;
+            case 's':
+                handshake = false;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t threads] [-d seconds] [-a addr] [-l len] [-s] port...\n", argv[0]);
+                return 2;
+        }
+    }
+
+    unsigned nports = (unsigned)(argc - optind);
+    if (nports == 0u)
+    {
+        fprintf(stderr, "need at least one port\n");
+        return 2;
+    }
+    if (threads > nports)
+        threads = nports;
+
+    host_link_t* links   = calloc(nports, sizeof *links);
+    worker_t*    workers = calloc(threads, sizeof *workers);
+    if (links == NULL || workers == NULL)
+        return 1;
+
+    for (unsigned t = 0; t < threads; ++t)
+        workers[t].links = calloc(nports / threads + 1u, sizeof(host_link_t*));
+
+    /* open and register every port up front; the link registry is not thread-safe */
+    for (unsigned i = 0; i < nports; ++i)
+    {
+        host_link_t* h = &links[i];
+        worker_t*    w = &workers[i % threads];
+
+        if (!dl_posix_port_open(&h->port, argv[optind + (int)i], 9600u))
+        {
+            perror(argv[optind + (int)i]);
+            return 1;
+        }
+        if (dl_link_init(&h->link, &dl_transport_posix, &h->port) != DL_OK)
+        {
+            fprintf(stderr, "more than DL_MAX_LINKS (%u) ports\n", (unsigned)DL_MAX_LINKS);
+            return 1;
+        }
+        if (handshake && !dl_link_handshake_quick(&h->link, 1u, 3u, 25u, 80u))
+            fprintf(stderr, "%s: no handshake, trying anyway\n", argv[optind + (int)i]);
+
+        h->w = w;
+        w->links[w->count++] = h;
+    }
+
+    uint64_t t0 = now_us();
+    s_end_us = t0 + (uint64_t)seconds * 1000000u;
+
+    for (unsigned t = 0; t < threads; ++t)
+        pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]);
+    for (unsigned t = 0; t < threads; ++t)
+        pthread_join(workers[t].thread, NULL);
+
+    double   elapsed = (double)(now_us() - t0) / 1e6;
+    uint64_t ok = 0, failed = 0;
+    size_t   total = 0;
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        ok     += workers[t].ok;
+        failed += workers[t].failed;
+        total  += workers[t].lat_n;
+    }
+
+    uint32_t* lat = malloc((total ? total : 1u) * sizeof *lat);
+    size_t    pos = 0;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        memcpy(&lat[pos], workers[t].lat_us, workers[t].lat_n * sizeof *lat);
+        pos += workers[t].lat_n;
+    }
+    qsort(lat, total, sizeof *lat, cmp_u32);
+
+    printf("ports,threads,seconds,ok,failed,tps,p50_us,p95_us,p99_us,max_us\n");
+    printf("%u,%u,%.2f,%llu,%llu,%.1f,%u,%u,%u,%u\n", nports, threads, elapsed,
+           (unsigned long long)ok, (unsigned long long)failed, (double)ok / elapsed,
+           total ? lat[total / 2u] : 0u,
+           total ? lat[(total * 95u) / 100u] : 0u,
+           total ? lat[(total * 99u) / 100u] : 0u,
+           total ? lat[total - 1u] : 0u);
+
+    for (unsigned i = 0; i < nports; ++i)
+        dl_posix_port_close(&links[i].port);
+    return 0;
+}
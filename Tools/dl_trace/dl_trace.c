@@ -0,0 +1,165 @@
+/* dl_trace - decodes a DataLink TRACE DUMP into text or a pcap file.
+ *
+ * Capture the console while issuing TRACE DUMP (any terminal log or e.g.
+ * `cat /dev/ttyACM0 > dump.bin`); the decoder skips everything before the "DLTR" header.
+ * Text output has one line per frame: time since the first entry, direction, wire length,
+ * flags, the time an RX frame took since the last TX (turnaround) and the captured bytes.
+ * The pcap uses LINKTYPE_USER0; each packet is the flags byte followed by the frame.
+ *
+ * Build (from the repository root):
+ *   gcc -O2 -std=gnu11 -IDataLink/Driver -o dl_trace Tools/dl_trace/dl_trace.c
+ *
+ * Usage: dl_trace [-p out.pcap] [dump file]      (reads stdin without a file)
+ */
+#define _GNU_SOURCE
+
+#include "DataLink_Trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TRACE_MAX_INPUT        (1u << 20)
+#define PCAP_LINKTYPE_USER0    147u
+
+static uint32_t get_le(const uint8_t* p, unsigned n)
+{
+    uint32_t v = 0u;
+    while (n--)
+        v = (v << 8) | p[n];
+    return v;
+}
+
+static void put_u32(FILE* f, uint32_t v) { (void)fwrite(&v, 4u, 1u, f); }
+static void put_u16(FILE* f, uint16_t v) { (void)fwrite(&v, 2u, 1u, f); }
+
+static void flag_names(uint8_t flags, char* out, size_t cap)
+{
+    snprintf(out, cap, "%s%s%s%s", (flags & DL_TRACE_CRC_BAD) ? "CRC " : "",
+             (flags & DL_TRACE_TIMEOUT) ? "TIMEOUT " : "", (flags & DL_TRACE_REJECTED) ? "REJECTED " : "",
+             (flags & DL_TRACE_OVERRUN) ? "OVERRUN " : "");
+    if (out[0] == '\0')
+        snprintf(out, cap, "-");
+    else
+        out[strlen(out) - 1u] = '\0';
+}
+
+int main(int argc, char** argv)
+{
+    const char* pcap_path = NULL;
+    FILE*       in        = stdin;
+    int         opt;
+
+    while ((opt = getopt(argc, argv, "p:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p': pcap_path = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-p out.pcap] [dump file]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind < argc && (in = fopen(argv[optind], "rb")) == NULL)
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    uint8_t* buf = malloc(TRACE_MAX_INPUT);
+    if (buf == NULL)
+        return 1;
+    size_t len = fread(buf, 1u, TRACE_MAX_INPUT, in);
+
+    const uint8_t* h = memmem(buf, len, DL_TRACE_MAGIC, 4u);
+    if (h == NULL || (size_t)(buf + len - h) < DL_TRACE_HDR_SIZE)
+    {
+        fprintf(stderr, "no trace dump found\n");
+        return 1;
+    }
+    if (h[4] != DL_TRACE_VERSION || h[5] < 8u || h[6] > h[5] - 8u)
+    {
+        fprintf(stderr, "unsupported dump (version %u, entry size %u, snap %u)\n", h[4], h[5], h[6]);
+        return 1;
+    }
+
+    unsigned esize = h[5];
+    unsigned count = get_le(&h[8], 2u);
+    uint32_t now   = get_le(&h[10], 4u);
+    const uint8_t* e = h + DL_TRACE_HDR_SIZE;
+
+    if ((size_t)(buf + len - e) < (size_t)count * esize)
+    {
+        count = (unsigned)((size_t)(buf + len - e) / esize);
+        fprintf(stderr, "dump truncated, decoding %u entries\n", count);
+    }
+
+    FILE* pcap = NULL;
+    if (pcap_path != NULL)
+    {
+        if ((pcap = fopen(pcap_path, "wb")) == NULL)
+        {
+            perror(pcap_path);
+            return 1;
+        }
+        put_u32(pcap, 0xA1B2C3D4u);
+        put_u16(pcap, 2u);
+        put_u16(pcap, 4u);
+        put_u32(pcap, 0u);
+        put_u32(pcap, 0u);
+        put_u32(pcap, 65535u);
+        put_u32(pcap, PCAP_LINKTYPE_USER0);
+    }
+    else
+    {
+        printf("# %u entries, snap %u bytes, last entry %.3f ms before the dump\n", count, h[6],
+               count ? (double)(uint32_t)(now - get_le(e + (size_t)(count - 1u) * esize, 4u)) / 1000.0 : 0.0);
+        printf("# t_ms dir len flags turnaround_ms bytes\n");
+    }
+
+    /* the 32-bit us clock wraps every ~71 min: unwrap by accumulating differences */
+    uint64_t t      = 0u;
+    uint64_t last_tx = UINT64_MAX;
+    uint32_t prev   = count ? get_le(e, 4u) : 0u;
+
+    for (unsigned i = 0; i < count; ++i, e += esize)
+    {
+        uint32_t ts    = get_le(e, 4u);
+        uint8_t  flags = e[4];
+        uint8_t  wlen  = e[5];
+        uint8_t  cap   = e[6] <= h[6] ? e[6] : h[6];
+
+        t   += (uint32_t)(ts - prev);
+        prev = ts;
+
+        if (pcap != NULL)
+        {
+            put_u32(pcap, (uint32_t)(t / 1000000u));
+            put_u32(pcap, (uint32_t)(t % 1000000u));
+            put_u32(pcap, 1u + cap);
+            put_u32(pcap, 1u + wlen);
+            (void)fwrite(&flags, 1u, 1u, pcap);
+            (void)fwrite(e + 8, 1u, cap, pcap);
+            continue;
+        }
+
+        char fl[32];
+        flag_names(flags, fl, sizeof fl);
+        printf("%10.3f %s %3u %-8s ", (double)t / 1000.0, (flags & DL_TRACE_RX) ? "RX" : "TX", wlen, fl);
+        if ((flags & DL_TRACE_RX) && last_tx != UINT64_MAX)
+            printf("%8.3f ", (double)(t - last_tx) / 1000.0);
+        else
+            printf("%8s ", "-");
+        for (unsigned k = 0; k < cap; ++k)
+            printf("%02X", e[8 + k]);
+        printf("%s\n", cap < wlen ? "..." : "");
+
+        if (!(flags & DL_TRACE_RX))
+            last_tx = t;
+    }
+
+    if (pcap != NULL)
+        fclose(pcap);
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Scaling benchmark: dl_host against N simulated Ocean devices, one CSV row per N.
+# Usage: Tools/ocean_sim/bench.sh [seconds] [threads] [N...]   (run from the repository root)
+set -e
+
+SECS=${1:-5}
+THREADS=${2:-1}
+shift 2 2>/dev/null || shift $#
+COUNTS=${*:-"1 4 16 64 256"}
+OUT=${BENCH_DIR:-/tmp/dl_bench}
+
+mkdir -p "$OUT"
+gcc -O2 -std=gnu11 -IDataLink/Driver -IDataLink/User -ITools/ocean_sim -o "$OUT/ocean_sim" \
+    Tools/ocean_sim/ocean_sim_main.c Tools/ocean_sim/ocean_sim.c DataLink/Driver/DataLink_Crc.c
+gcc -O2 -std=gnu11 -pthread -DDL_MAX_LINKS=1024 -IDataLink/Driver -IDataLink/HAL -o "$OUT/dl_host" \
+    Tools/dl_host/dl_host.c DataLink/Driver/DataLink_Driver.c DataLink/Driver/DataLink_Crc.c \
+    DataLink/Driver/DataLink_Trace.c DataLink/HAL/DataLink_TransportPosix.c
+
+header=1
+for n in $COUNTS; do
+    "$OUT/ocean_sim" -n "$n" > "$OUT/ports.txt" &
+    sim=$!
+    while ! grep -q '^ready$' "$OUT/ports.txt" 2>/dev/null; do sleep 0.1; done
+
+    "$OUT/dl_host" -t "$THREADS" -d "$SECS" $(grep '^/' "$OUT/ports.txt") > "$OUT/run.csv"
+    kill "$sim"; wait "$sim" 2>/dev/null || true
+
+    if [ $header = 1 ]; then head -n 1 "$OUT/run.csv"; header=0; fi
+    tail -n 1 "$OUT/run.csv"
+done
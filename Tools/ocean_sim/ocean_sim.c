@@ -0,0 +1,348 @@
+#include "ocean_sim.h"
+#include "DataLink_Driver.h"   /* DL_TYPE_*, DL_OVERHEAD, DL_MAX_READ / DL_MAX_WRITE */
+#include "DataLink_Crc.h"
+#include "Ocean_Registers.h"
+#include <string.h>
+
+/* Registers the PoC touches that Ocean_Registers.h keeps as literals. */
+#define SIM_ADDR_CHANNEL_POWER   0x000Au   /* channel power report, Q2.6 U16 */
+#define SIM_ADDR_FIRMWARE        0x000Cu   /* U32 */
+#define SIM_ADDR_PRODUCT_ID      0x0010u   /* U32 */
+#define SIM_ADDR_MEAS_CH4_V      0x0118u   /* 4 x (voltage Q14.2, current Q9.7), channel 4 first */
+#define SIM_ADDR_MEAS_OUT_V      0x0128u   /* output voltage Q14.2 */
+#define SIM_ADDR_ERROR_FLAGS     0x0004u   /* U32 */
+#define SIM_ADDR_OUTPUT_STATE    0x800Cu   /* U8 */
+#define SIM_ADDR_RESET_ERROR     0x8014u   /* U32 mask, write 1 to clear */
+#define SIM_ADDR_NUM_CHANNELS    0x8109u   /* U8 */
+#define SIM_PROTECTED_END        0x8110u   /* 0x8108..0x810F need an unlock */
+
+#define SIM_STATUS_OK            0x00u
+#define SIM_STATUS_LOCKED        0x01u
+#define SIM_STATUS_READ_ONLY     0x02u
+#define SIM_STATUS_RANGE         0x03u
+
+#define SIM_CH_VOLT              12.0f     /* nominal channel voltage */
+
+static uint32_t sim_rand(ocean_sim_t* s)
+{
+    uint32_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->rng = x;
+    return x;
+}
+
+static bool sim_chance(ocean_sim_t* s, uint32_t ppm)
+{
+    return ppm != 0u && (sim_rand(s) % 1000000u) < ppm;
+}
+
+static void put_le16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t* p, uint32_t v)
+{
+    put_le16(p, (uint16_t)v);
+    put_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t get_le32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool overlaps(uint16_t addr, uint8_t len, uint32_t lo, uint32_t hi)
+{
+    return (uint32_t)addr < hi && (uint32_t)addr + len > lo;
+}
+
+/* Recomputes the read-only mirrors and measurements from the setpoints. */
+static void sim_refresh(ocean_sim_t* s)
+{
+    uint8_t* r     = s->regs;
+    uint8_t  nc    = r[SIM_ADDR_NUM_CHANNELS];
+    uint8_t  q26   = r[OCEAN_ADDR_CHANNEL_POWER_SET];
+    bool     on    = r[SIM_ADDR_OUTPUT_STATE] != 0u;
+    float    watts = (float)q26 / 64.0f;
+
+    r[OCEAN_ADDR_STATUS] = on ? 0x01u : 0x00u;
+    r[OCEAN_ADDR_DEVICE_INFO] = nc;
+    put_le16(&r[SIM_ADDR_CHANNEL_POWER], q26);
+
+    for (uint8_t ch = 1u; ch <= 4u; ++ch)
+    {
+        uint16_t at    = (uint16_t)(SIM_ADDR_MEAS_CH4_V + (4u - ch) * 4u);
+        bool     live  = on && ch <= nc;
+        float    volt  = live ? SIM_CH_VOLT + (float)(sim_rand(s) % 9u) * 0.25f - 1.0f : 0.0f;
+        float    amp   = live ? watts / volt : 0.0f;
+
+        put_le16(&r[at],      (uint16_t)(volt * 4.0f + 0.5f));
+        put_le16(&r[at + 2u], (uint16_t)(amp * 128.0f + 0.5f));
+    }
+    put_le16(&r[SIM_ADDR_MEAS_OUT_V], on ? (uint16_t)(SIM_CH_VOLT * 4.0f) : 0u);
+
+    put_le32(&r[OCEAN_ADDR_TEMPERATURE_SUM], get_le32(&r[OCEAN_ADDR_TEMPERATURE_SUM]) + 25u);
+}
+
+void ocean_sim_init(ocean_sim_t* s, const ocean_sim_cfg_t* cfg)
+{
+    memset(s, 0, sizeof(*s));
+    s->cfg = *cfg;
+    if (s->cfg.baud == 0u)
+        s->cfg.baud = 9600u;
+    s->rng = cfg->seed ? cfg->seed : 0x1234567u;
+
+    s->regs[SIM_ADDR_NUM_CHANNELS]        = 1u;
+    s->regs[OCEAN_ADDR_CHANNEL_POWER_SET] = 32u;     /* 0.5 W */
+    s->regs[SIM_ADDR_OUTPUT_STATE]        = 1u;
+    put_le32(&s->regs[SIM_ADDR_FIRMWARE],   0x00010203u);
+    put_le32(&s->regs[SIM_ADDR_PRODUCT_ID], 0x0000C0DEu);
+    put_le32(&s->regs[OCEAN_ADDR_FACTORY_CONFIG], 0x00A5F00Du ^ s->rng);
+    sim_refresh(s);
+}
+
+static void sim_queue(ocean_sim_t* s, uint64_t at, uint8_t b)
+{
+    if (s->tx_count < OCEAN_SIM_TXQ)
+    {
+        uint16_t slot = (uint16_t)((s->tx_head + s->tx_count) % OCEAN_SIM_TXQ);
+        s->tx[slot]    = b;
+        s->tx_at[slot] = at;
+        s->tx_count++;
+    }
+}
+
+/* Queues one response frame (CRC appended) at baud-rate spacing after 'start_us'. */
+static void sim_send(ocean_sim_t* s, uint64_t start_us, uint8_t* f, uint8_t n)
+{
+    uint16_t c       = crc16_compute(f, n, CRC16_INIT);
+    uint64_t byte_us = 10000000u / s->cfg.baud;
+
+    f[n]     = (uint8_t)c;
+    f[n + 1] = (uint8_t)(c >> 8);
+    n        = (uint8_t)(n + DL_CRC_SIZE);
+
+    if (start_us < s->tx_free_us)
+        start_us = s->tx_free_us;
+
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        uint64_t at = start_us + (uint64_t)(i + 1u) * byte_us;
+        uint8_t  b  = f[i];
+
+        s->tx_free_us = at;
+        if (sim_chance(s, s->cfg.drop_ppm))
+        {
+            s->stats.dropped++;
+            continue;
+        }
+        if (sim_chance(s, s->cfg.corrupt_ppm))
+        {
+            b ^= (uint8_t)(1u << (sim_rand(s) & 7u));
+            s->stats.corrupted++;
+        }
+        sim_queue(s, at, b);
+    }
+    s->stats.frames_tx++;
+}
+
+/* Line noise: 1..OCEAN_SIM_JUNK_MAX random bytes from 'start_us'; returns when they end. */
+static uint64_t sim_junk(ocean_sim_t* s, uint64_t start_us)
+{
+    uint64_t byte_us = 10000000u / s->cfg.baud;
+    uint32_t n       = 1u + sim_rand(s) % OCEAN_SIM_JUNK_MAX;
+
+    if (start_us < s->tx_free_us)
+        start_us = s->tx_free_us;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        start_us += byte_us;
+        sim_queue(s, start_us, (uint8_t)sim_rand(s));
+    }
+    s->tx_free_us = start_us;
+    s->stats.junk += n;
+    return start_us;
+}
+
+static void sim_respond(ocean_sim_t* s, uint64_t now_us, uint8_t* f, uint8_t n)
+{
+    uint64_t start = now_us + s->cfg.latency_us;
+
+    if (s->cfg.jitter_us)
+        start += sim_rand(s) % (s->cfg.jitter_us + 1u);
+    if (sim_chance(s, s->cfg.junk_ppm))
+        start = sim_junk(s, start);
+    sim_send(s, start, f, n);
+}
+
+static uint8_t sim_write(ocean_sim_t* s, uint64_t now_us, uint16_t addr, uint8_t len, const uint8_t* data)
+{
+    bool reconfig;
+
+    if (addr < 0x8000u)
+        return SIM_STATUS_READ_ONLY;
+    if ((uint32_t)addr + len > 0x10000u)
+        return SIM_STATUS_RANGE;
+
+    if (overlaps(addr, len, OCEAN_ADDR_UNLOCK, OCEAN_ADDR_UNLOCK + OCEAN_LEN_UNLOCK))
+    {
+        memcpy(&s->regs[addr], data, len);
+        s->unlocked = get_le32(&s->regs[OCEAN_ADDR_UNLOCK])     == OCEAN_UNLOCK_KEY0 &&
+                      get_le32(&s->regs[OCEAN_ADDR_UNLOCK + 4u]) == OCEAN_UNLOCK_KEY1;
+        memset(&s->regs[OCEAN_ADDR_UNLOCK], 0, OCEAN_LEN_UNLOCK);
+        return SIM_STATUS_OK;
+    }
+
+    reconfig = overlaps(addr, len, OCEAN_ADDR_CHANNEL_POWER_SET, SIM_PROTECTED_END);
+    if (reconfig)
+    {
+        if (s->cfg.require_unlock && !s->unlocked)
+            return SIM_STATUS_LOCKED;
+        s->unlocked = false;            /* one unlock covers one write */
+    }
+
+    memcpy(&s->regs[addr], data, len);
+    if (s->regs[SIM_ADDR_NUM_CHANNELS] < 1u || s->regs[SIM_ADDR_NUM_CHANNELS] > 4u)
+        s->regs[SIM_ADDR_NUM_CHANNELS] = 1u;
+
+    if (overlaps(addr, len, SIM_ADDR_RESET_ERROR, SIM_ADDR_RESET_ERROR + 4u))
+    {
+        put_le32(&s->regs[SIM_ADDR_ERROR_FLAGS],
+                 get_le32(&s->regs[SIM_ADDR_ERROR_FLAGS]) & ~get_le32(&s->regs[SIM_ADDR_RESET_ERROR]));
+        put_le32(&s->regs[SIM_ADDR_RESET_ERROR], 0u);
+    }
+
+    if (reconfig && s->cfg.stall_us)
+        s->stall_until_us = now_us + s->cfg.latency_us + s->cfg.stall_us;
+
+    return SIM_STATUS_OK;
+}
+
+/* Handles one CRC-checked request. */
+static void sim_request(ocean_sim_t* s, uint64_t now_us, const uint8_t* rq)
+{
+    uint8_t  f[DL_MAX_FRAME + DL_CRC_SIZE];
+    uint16_t addr = (uint16_t)rq[2] | ((uint16_t)rq[3] << 8);
+    uint8_t  len  = rq[4];
+
+    s->stats.frames_rx++;
+
+    switch (rq[0])
+    {
+        case DL_TYPE_RESET:
+            s->unlocked = false;
+            f[0] = DL_TYPE_RESET_RESP;
+            f[1] = DL_OVERHEAD;
+            sim_respond(s, now_us, f, DL_HDR_SIZE);
+            break;
+
+        case DL_TYPE_READ:
+            f[0] = DL_TYPE_READ_RESP;
+            f[2] = SIM_STATUS_OK;
+            f[3] = rq[2];
+            f[4] = rq[3];
+            f[5] = len;
+            if (len > DL_MAX_READ || (uint32_t)addr + len > 0x10000u)
+            {
+                f[2] = SIM_STATUS_RANGE;
+                len  = 0u;
+            }
+            sim_refresh(s);
+            memcpy(&f[6], &s->regs[addr], len);
+            f[1] = (uint8_t)(DL_OVERHEAD + 4u + len);
+            sim_respond(s, now_us, f, (uint8_t)(6u + len));
+            break;
+
+        case DL_TYPE_WRITE:
+            f[0] = DL_TYPE_WRITE_RESP;
+            f[1] = DL_OVERHEAD + 4u;
+            f[2] = (len <= DL_MAX_WRITE) ? sim_write(s, now_us, addr, len, &rq[5]) : SIM_STATUS_RANGE;
+            f[3] = rq[2];
+            f[4] = rq[3];
+            f[5] = len;
+            if (f[2] != SIM_STATUS_OK)
+                s->stats.rejected++;
+            sim_respond(s, now_us, f, 6u);
+
+            /* a reconfiguring device comes back with its own reset */
+            if (s->stall_until_us > now_us && s->cfg.reset_after_stall)
+            {
+                f[0] = DL_TYPE_RESET;
+                f[1] = DL_OVERHEAD;
+                sim_send(s, s->stall_until_us, f, DL_HDR_SIZE);
+            }
+            break;
+
+        default:                        /* RESET_RESP answering our reset: nothing to do */
+            break;
+    }
+}
+
+static bool sim_request_type(uint8_t t)
+{
+    return t == DL_TYPE_READ || t == DL_TYPE_WRITE || t == DL_TYPE_RESET || t == DL_TYPE_RESET_RESP;
+}
+
+void ocean_sim_rx(ocean_sim_t* s, uint64_t now_us, const uint8_t* p, uint16_t n)
+{
+    if (s->rx_n != 0u && (now_us - s->rx_last_us) > OCEAN_SIM_RX_GAP_US)
+        s->rx_n = 0u;
+    s->rx_last_us = now_us;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        s->rx[s->rx_n++] = p[i];
+
+        for (;;)
+        {
+            /* resynchronise on anything that cannot start a request */
+            while (s->rx_n != 0u &&
+                   (!sim_request_type(s->rx[0]) ||
+                    (s->rx_n >= DL_HDR_SIZE && (s->rx[1] < DL_OVERHEAD || s->rx[1] > DL_OVERHEAD + 3u + DL_MAX_WRITE))))
+            {
+                memmove(s->rx, &s->rx[1], --s->rx_n);
+            }
+
+            if (s->rx_n < DL_HDR_SIZE || s->rx_n < s->rx[1])
+                break;
+
+            if (crc16_compute(s->rx, s->rx[1], CRC16_INIT) != 0u)
+            {
+                /* false start or damaged request: retry one byte later */
+                s->stats.crc_errors++;
+                memmove(s->rx, &s->rx[1], --s->rx_n);
+                continue;
+            }
+
+            if (now_us < s->stall_until_us)
+                s->stats.ignored++;
+            else
+                sim_request(s, now_us, s->rx);
+            s->rx_n = 0u;
+            break;
+        }
+    }
+}
+
+uint16_t ocean_sim_tx(ocean_sim_t* s, uint64_t now_us, uint8_t* out, uint16_t max)
+{
+    uint16_t n = 0u;
+
+    while (n < max && s->tx_count != 0u && s->tx_at[s->tx_head] <= now_us)
+    {
+        out[n++]   = s->tx[s->tx_head];
+        s->tx_head = (uint16_t)((s->tx_head + 1u) % OCEAN_SIM_TXQ);
+        s->tx_count--;
+    }
+    return n;
+}
+
+uint64_t ocean_sim_next_us(const ocean_sim_t* s)
+{
+    return s->tx_count ? s->tx_at[s->tx_head] : UINT64_MAX;
+}
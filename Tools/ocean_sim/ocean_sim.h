@@ -0,0 +1,82 @@
+#ifndef OCEAN_SIM_H
+#define OCEAN_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Host-side model of one Ocean device speaking DataLink. It has no clock or I/O of its own:
+ * the caller feeds host bytes with ocean_sim_rx() and collects response bytes with
+ * ocean_sim_tx() at times it chooses, so the same model runs against a pty in real time
+ * (ocean_sim_main.c) or under a virtual clock. Given the same config, seed and input
+ * timing, every run produces the same bytes at the same times. */
+
+#define OCEAN_SIM_TXQ          512u     /* response bytes in flight (several frames) */
+#define OCEAN_SIM_RX_GAP_US    20000u   /* silence that discards a partial request */
+#define OCEAN_SIM_JUNK_MAX     8u       /* line noise ahead of a response: 1..this many bytes */
+
+typedef struct {
+    uint32_t baud;                      /* byte time = 10 bits; 9600 like USART1 */
+    uint32_t latency_us;                /* end of request -> first response byte */
+    uint32_t jitter_us;                 /* added uniformly in [0, jitter_us] per response */
+    uint32_t stall_us;                  /* busy time after a channel/power reconfiguration */
+    uint32_t drop_ppm;                  /* response bytes lost, per million */
+    uint32_t corrupt_ppm;               /* response bytes with a flipped bit, per million */
+    uint32_t junk_ppm;                  /* responses preceded by random bytes, per million */
+    uint32_t seed;                      /* fault / jitter / measurement-noise generator */
+    bool     require_unlock;            /* protected writes need the two unlock keys first */
+    bool     reset_after_stall;         /* device sends RESET once a reconfiguration ends */
+} ocean_sim_cfg_t;
+
+typedef struct {
+    uint32_t frames_rx;                 /* valid requests */
+    uint32_t frames_tx;                 /* responses and device resets queued */
+    uint32_t crc_errors;                /* requests dropped for a bad CRC */
+    uint32_t ignored;                   /* requests that arrived during a stall */
+    uint32_t rejected;                  /* writes answered with a non-zero status */
+    uint32_t dropped;                   /* injected byte losses */
+    uint32_t corrupted;                 /* injected bit flips */
+    uint32_t junk;                      /* injected noise bytes ahead of responses */
+} ocean_sim_stats_t;
+
+typedef struct {
+    ocean_sim_cfg_t   cfg;
+    ocean_sim_stats_t stats;
+
+    uint8_t  regs[0x10000];             /* flat register file, little-endian fields */
+    bool     unlocked;
+
+    uint8_t  rx[128];                   /* request being assembled */
+    uint16_t rx_n;
+    uint64_t rx_last_us;
+
+    uint8_t  tx[OCEAN_SIM_TXQ];         /* queued response bytes and their due times */
+    uint64_t tx_at[OCEAN_SIM_TXQ];
+    uint16_t tx_head;
+    uint16_t tx_count;
+    uint64_t tx_free_us;                /* when the line is free for the next byte */
+
+    uint64_t stall_until_us;
+    uint32_t rng;
+} ocean_sim_t;
+
+/* Power-on state: 1 channel, 0.5 W setpoint, output on, locked. */
+void     ocean_sim_init(ocean_sim_t* s, const ocean_sim_cfg_t* cfg);
+
+/* Host -> device bytes received at 'now_us'. */
+void     ocean_sim_rx(ocean_sim_t* s, uint64_t now_us, const uint8_t* p, uint16_t n);
+
+/* Device -> host bytes due by 'now_us' (up to 'max'). Returns the number copied. */
+uint16_t ocean_sim_tx(ocean_sim_t* s, uint64_t now_us, uint8_t* out, uint16_t max);
+
+/* Due time of the next queued response byte, or UINT64_MAX when the line is quiet. */
+uint64_t ocean_sim_next_us(const ocean_sim_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OCEAN_SIM_H */
@@ -0,0 +1,149 @@
+/* ocean_sim - simulated Ocean devices on pseudo-terminals.
+ *
+ * Creates N ptys, prints the slave path of each (one per line, then "ready"), and serves
+ * every one with its own ocean_sim_t in real time until killed. Point the DataLink host
+ * tool (Tools/dl_host) or any serial client at the printed paths.
+ *
+ * Build (from the repository root):
+ *   gcc -O2 -std=gnu11 -IDataLink/Driver -IDataLink/User -ITools/ocean_sim \
+ *       -o ocean_sim Tools/ocean_sim/ocean_sim_main.c Tools/ocean_sim/ocean_sim.c \
+ *       DataLink/Driver/DataLink_Crc.c
+ *
+ * Usage: ocean_sim [-n devices] [-b baud] [-L latency_us] [-J jitter_us] [-S stall_ms]
+ *                  [-D drop_ppm] [-C corrupt_ppm] [-G junk_ppm] [-s seed] [-u] [-R]
+ *   -G puts 1..8 random bytes ahead of that share of responses (per million),
+ *   -u accepts protected writes without an unlock, -R sends a device RESET after a stall.
+ *   Device i uses seed + i, so runs with the same options are reproducible.
+ */
+#define _GNU_SOURCE
+
+#include "ocean_sim.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    int         fd;                     /* pty master */
+    int         slave;                  /* held open so the master never reports a hangup */
+    ocean_sim_t sim;
+} sim_port_t;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static bool open_pty(sim_port_t* p)
+{
+    struct termios t;
+
+    p->fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (p->fd < 0 || grantpt(p->fd) != 0 || unlockpt(p->fd) != 0)
+        return false;
+
+    /* raw on the slave side too, so nothing rewrites the binary frames */
+    p->slave = open(ptsname(p->fd), O_RDWR | O_NOCTTY);
+    if (p->slave < 0 || tcgetattr(p->slave, &t) != 0)
+        return false;
+    cfmakeraw(&t);
+    return tcsetattr(p->slave, TCSANOW, &t) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    ocean_sim_cfg_t cfg = { .baud = 9600u, .latency_us = 3000u, .stall_us = 0u,
+                            .seed = 1u, .require_unlock = true };
+    unsigned        n   = 1u;
+    int             opt;
+
+    while ((opt = getopt(argc, argv, "n:b:L:J:S:D:C:G:s:uR")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': n                     = (unsigned)strtoul(optarg, NULL, 0);          break;
+            case 'b': cfg.baud              = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'L': cfg.latency_us        = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'J': cfg.jitter_us         = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'S': cfg.stall_us          = (uint32_t)strtoul(optarg, NULL, 0) * 1000u;  break;
+            case 'D': cfg.drop_ppm          = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'C': cfg.corrupt_ppm       = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'G': cfg.junk_ppm          = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 's': cfg.seed              = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'u': cfg.require_unlock    = false;                                       break;
+            case 'R': cfg.reset_after_stall = true;                                        break;
+            default:
+                fprintf(stderr, "usage: %s [-n devices] [-b baud] [-L latency_us] [-J jitter_us] [-S stall_ms]"
+                                " [-D drop_ppm] [-C corrupt_ppm] [-G junk_ppm] [-s seed] [-u] [-R]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (n == 0u || cfg.baud == 0u)
+        return 2;
+
+    sim_port_t*    ports = calloc(n, sizeof *ports);
+    struct pollfd* pfd   = calloc(n, sizeof *pfd);
+    if (ports == NULL || pfd == NULL)
+        return 1;
+
+    for (unsigned i = 0; i < n; ++i)
+    {
+        ocean_sim_cfg_t c = cfg;
+        c.seed += i;
+
+        if (!open_pty(&ports[i]))
+        {
+            perror("posix_openpt");
+            return 1;
+        }
+        ocean_sim_init(&ports[i].sim, &c);
+        pfd[i].fd     = ports[i].fd;
+        pfd[i].events = POLLIN;
+        printf("%s\n", ptsname(ports[i].fd));
+    }
+    printf("ready\n");
+    fflush(stdout);
+
+    for (;;)
+    {
+        uint64_t t    = now_us();
+        uint64_t next = UINT64_MAX;
+        uint8_t  buf[256];
+
+        for (unsigned i = 0; i < n; ++i)
+        {
+            uint16_t k = ocean_sim_tx(&ports[i].sim, t, buf, sizeof buf);
+            if (k != 0u && write(ports[i].fd, buf, k) < 0 && errno != EAGAIN && errno != EIO)
+                perror("write");
+
+            uint64_t due = ocean_sim_next_us(&ports[i].sim);
+            if (due < next)
+                next = due;
+        }
+
+        int wait_ms = (next == UINT64_MAX) ? 1000 : (next <= t) ? 0 : (int)((next - t + 999u) / 1000u);
+        int r       = poll(pfd, n, wait_ms);
+        if (r < 0 && errno != EINTR)
+        {
+            perror("poll");
+            return 1;
+        }
+
+        t = now_us();
+        for (unsigned i = 0; r > 0 && i < n; ++i)
+        {
+            if (pfd[i].revents & POLLIN)
+            {
+                ssize_t k = read(ports[i].fd, buf, sizeof buf);
+                if (k > 0)
+                    ocean_sim_rx(&ports[i].sim, t, buf, (uint16_t)k);
+            }
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Host tests of the DataLink firmware sources: builds every test and runs it; exits non-zero
+# on the first failure. Usage: Tools/tests/run_tests.sh   (run from the repository root)
+set -e
+
+OUT=${TEST_DIR:-/tmp/dl_tests}
+CC=${CC:-gcc}
+CFLAGS="-O2 -std=gnu11 -Wall -Wextra"
+
+mkdir -p "$OUT"
+
+echo "== test_rxring"
+$CC $CFLAGS -IDataLink/Driver -o "$OUT/test_rxring" \
+    Tools/tests/test_rxring.c DataLink/Driver/DataLink_RxRing.c
+"$OUT/test_rxring"
+
+for k in 0 1 2 3; do
+    echo "== test_crc (DL_CRC_KERNEL=$k)"
+    $CC $CFLAGS -DDL_CRC_KERNEL=$k -IDataLink/Driver -o "$OUT/test_crc$k" Tools/tests/test_crc.c
+    "$OUT/test_crc$k"
+done
+
+echo "== vhal_test"
+$CC $CFLAGS -ITools/vhal/Inc -ITools/vhal -ITools/ocean_sim -IDataLink/Driver -IDataLink/HAL -IDataLink/User \
+    -o "$OUT/vhal_test" Tools/vhal/vhal_test.c Tools/vhal/vhal.c Tools/ocean_sim/ocean_sim.c \
+    DataLink/Driver/DataLink_Driver.c DataLink/Driver/DataLink_Crc.c DataLink/Driver/DataLink_RxRing.c \
+    DataLink/Driver/DataLink_Trace.c DataLink/HAL/DataLink_TransportHal.c DataLink/HAL/DataLink_HAL.c \
+    DataLink/User/DataLink_User.c -lm
+"$OUT/vhal_test"
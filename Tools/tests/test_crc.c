@@ -0,0 +1,212 @@
+/* test_crc - host unit test of the DataLink CRC16 kernels (DataLink_Crc.c).
+ *
+ * Checks the kernel selected by DL_CRC_KERNEL against a bit-by-bit CRC of the same
+ * definition (reflected polynomial 0xD745, i.e. 0xA2EB, init 0xFFFF): crc16_compute() over
+ * random buffers at every length up to twice the largest frame, from unaligned starts and
+ * with arbitrary init values (the slicing kernels have separate head, body and tail paths);
+ * crc16_update() byte by byte; and the zero residue of a frame with its CRC appended.
+ * The compile-time tables are also compared entry by entry with the table the driver used
+ * to build at boot, from 0xA2EB through a bit reversal, so the hard-coded 0xD745 is checked
+ * independently. DataLink_Crc.c is included rather than linked, for its static slicing tables.
+ *
+ * Build and run one kernel (from the repository root), or use Tools/tests/run_tests.sh,
+ * which runs all four:
+ *   gcc -O2 -std=gnu11 -Wall -Wextra -DDL_CRC_KERNEL=0 -IDataLink/Driver -o test_crc \
+ *       Tools/tests/test_crc.c && ./test_crc
+ */
+#define _GNU_SOURCE
+
+#include "DataLink_Crc.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MAX_LEN           192u     /* twice a 96-byte frame */
+#define TEST_ROUNDS            2000u    /* random buffers per check */
+
+static unsigned s_failed;
+
+#define CHECK(cond, ...)                                                 \
+    do {                                                                 \
+        if (!(cond))                                                     \
+        {                                                                \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                  \
+            printf(__VA_ARGS__);                                         \
+            printf("\n");                                                \
+            s_failed++;                                                  \
+            return;                                                      \
+        }                                                                \
+    } while (0)
+
+static const char* const k_kernel_name[] = { "BYTE", "NIBBLE", "SLICE2", "SLICE4" };
+
+/* The former boot-time table: the Ocean polynomial bit-reversed at run time. */
+static uint16_t reverse_bits16(uint16_t x)
+{
+    x = (uint16_t)(((x >> 8) | (x << 8)));
+    x = (uint16_t)((((x & 0xF0F0u) >> 4) | ((x & 0x0F0Fu) << 4)));
+    x = (uint16_t)((((x & 0xCCCCu) >> 2) | ((x & 0x3333u) << 2)));
+    x = (uint16_t)((((x & 0xAAAAu) >> 1) | ((x & 0x5555u) << 1)));
+    return x;
+}
+
+static void runtime_lut(uint16_t lut[256])
+{
+    uint16_t rp = reverse_bits16(0xA2EBu);
+
+    for (int i = 0; i < 256; ++i)
+    {
+        uint16_t c = (uint16_t)i;
+        for (int b = 0; b < 8; ++b)
+            c = (uint16_t)(((c & 1u) ? ((c >> 1) ^ rp) : (c >> 1)));
+        lut[i] = c;
+    }
+}
+
+/* The reference: one bit per step, straight from the definition. */
+static uint16_t crc16_bitwise(const uint8_t* data, uint16_t len, uint16_t crc)
+{
+    for (uint16_t i = 0; i < len; ++i)
+    {
+        crc ^= data[i];
+        for (unsigned b = 0; b < 8u; ++b)
+            crc = (crc & 1u) ? (uint16_t)((crc >> 1) ^ 0xD745u) : (uint16_t)(crc >> 1);
+    }
+    return crc;
+}
+
+static void fill_random(uint8_t* p, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; ++i)
+        p[i] = (uint8_t)rand();
+}
+
+/* The kernel's tables against the boot-time table; each slicing table is one more round of
+ * it (byte x followed by one more zero byte), the nibble table its upper-nibble entries. */
+static void test_tables(void)
+{
+    uint16_t lut[256];
+    unsigned entries = 0u;
+
+    runtime_lut(lut);
+#if (DL_CRC_KERNEL == DL_CRC_KERNEL_NIBBLE)
+    for (unsigned j = 0; j < 16u; ++j, ++entries)
+        CHECK(crc16_nib[j] == lut[j << 4], "crc16_nib[%u] 0x%04X, boot-time 0x%04X", j, crc16_nib[j], lut[j << 4]);
+#else
+    for (unsigned i = 0; i < 256u; ++i, ++entries)
+        CHECK(crc16_lut[i] == lut[i], "crc16_lut[%u] 0x%04X, boot-time 0x%04X", i, crc16_lut[i], lut[i]);
+#endif
+#if (DL_CRC_KERNEL >= DL_CRC_KERNEL_SLICE2)
+    {
+#if (DL_CRC_KERNEL == DL_CRC_KERNEL_SLICE4)
+        const uint16_t* const slices[] = { crc16_lut1, crc16_lut2, crc16_lut3 };
+#else
+        const uint16_t* const slices[] = { crc16_lut1 };
+#endif
+        uint16_t prev[256];
+
+        memcpy(prev, lut, sizeof prev);
+        for (unsigned n = 0; n < sizeof slices / sizeof slices[0]; ++n)
+        {
+            for (unsigned i = 0; i < 256u; ++i, ++entries)
+            {
+                uint16_t want = (uint16_t)((prev[i] >> 8) ^ lut[prev[i] & 0xFFu]);
+                CHECK(slices[n][i] == want, "crc16_lut%u[%u] 0x%04X, boot-time 0x%04X", n + 1u, i, slices[n][i], want);
+                prev[i] = want;
+            }
+        }
+    }
+#endif
+    printf("ok   tables: %u entries match the table built at boot from 0xA2EB\n", entries);
+}
+
+/* Every length, every start offset mod 4, random init. */
+static void test_compute(void)
+{
+    uint8_t  buf[TEST_MAX_LEN + 4u];
+    unsigned spans = 0u;
+
+    for (unsigned round = 0; round < TEST_ROUNDS; ++round)
+    {
+        uint16_t len  = (uint16_t)(round % (TEST_MAX_LEN + 1u));
+        uint16_t off  = (uint16_t)((unsigned)rand() % 4u);
+        uint16_t init = (round & 1u) ? CRC16_INIT : (uint16_t)rand();
+        uint16_t want, got;
+
+        fill_random(buf, sizeof buf);
+        want = crc16_bitwise(buf + off, len, init);
+        got  = crc16_compute(buf + off, len, init);
+        CHECK(got == want, "len %u offset %u init 0x%04X: 0x%04X, reference 0x%04X", len, off, init, got, want);
+        spans++;
+    }
+    printf("ok   crc16_compute: %u random spans of 0..%u bytes match the bitwise CRC\n", spans, TEST_MAX_LEN);
+}
+
+/* A span split anywhere gives the same CRC as the whole: chained compute and streaming update. */
+static void test_update(void)
+{
+    uint8_t buf[TEST_MAX_LEN];
+
+    for (unsigned round = 0; round < TEST_ROUNDS; ++round)
+    {
+        uint16_t    len  = (uint16_t)(1u + (unsigned)rand() % TEST_MAX_LEN);
+        uint16_t    cut  = (uint16_t)((unsigned)rand() % (len + 1u));
+        uint16_t    want, chained;
+        crc16_ctx_t ctx;
+
+        fill_random(buf, len);
+        want = crc16_bitwise(buf, len, CRC16_INIT);
+
+        crc16_start(&ctx);
+        for (uint16_t i = 0; i < len; ++i)
+            crc16_update(&ctx, buf[i]);
+        CHECK(ctx.crc == want, "len %u: streaming 0x%04X, reference 0x%04X", len, ctx.crc, want);
+
+        chained = crc16_compute(buf + cut, (uint16_t)(len - cut), crc16_compute(buf, cut, CRC16_INIT));
+        CHECK(chained == want, "len %u split at %u: 0x%04X, reference 0x%04X", len, cut, chained, want);
+    }
+    printf("ok   crc16_update: %u random buffers, streamed and split, match the bitwise CRC\n", TEST_ROUNDS);
+}
+
+/* A frame with its CRC appended little-endian leaves a residue of 0; any flipped bit does not. */
+static void test_residue(void)
+{
+    uint8_t buf[TEST_MAX_LEN + 2u];
+
+    for (unsigned round = 0; round < TEST_ROUNDS; ++round)
+    {
+        uint16_t    len = (uint16_t)(1u + (unsigned)rand() % TEST_MAX_LEN);
+        uint16_t    crc, bit;
+        crc16_ctx_t ctx;
+
+        fill_random(buf, len);
+        crc = crc16_compute(buf, len, CRC16_INIT);
+        buf[len]      = (uint8_t)crc;
+        buf[len + 1u] = (uint8_t)(crc >> 8);
+
+        crc16_start(&ctx);
+        for (uint16_t i = 0; i < len + 2u; ++i)
+            crc16_update(&ctx, buf[i]);
+        CHECK(crc16_residue_ok(&ctx), "len %u: residue 0x%04X", len, ctx.crc);
+        CHECK(crc16_compute(buf, (uint16_t)(len + 2u), CRC16_INIT) == 0u, "len %u: compute residue not 0", len);
+
+        bit = (uint16_t)((unsigned)rand() % ((len + 2u) * 8u));
+        buf[bit / 8u] ^= (uint8_t)(1u << (bit % 8u));
+        CHECK(crc16_compute(buf, (uint16_t)(len + 2u), CRC16_INIT) != 0u, "len %u: bit %u flipped, residue still 0", len, bit);
+    }
+    printf("ok   residue: %u frames with CRC appended check to 0, single-bit errors do not\n", TEST_ROUNDS);
+}
+
+int main(void)
+{
+    srand(1u);
+    printf("kernel %s\n", k_kernel_name[DL_CRC_KERNEL]);
+
+    test_tables();
+    test_compute();
+    test_update();
+    test_residue();
+
+    printf("%s\n", s_failed ? "FAILED" : "PASSED");
+    return s_failed ? 1 : 0;
+}
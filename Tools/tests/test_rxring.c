@@ -0,0 +1,234 @@
+/* test_rxring - host unit test of the DataLink receive ring (DataLink_RxRing.c).
+ *
+ * The producer side is a fake circular DMA that writes the ring buffer byte by byte at
+ * 9600 baud and publishes its progress the way HAL_UARTEx_RxEventCallback does
+ * (DataLink_TransportHal.c): on the half-transfer, transfer-complete and idle-line events,
+ * with the DMA offset masked to the ring. The consumer reads at scheduled times with
+ * arbitrary chunk sizes. Checks wraparound over many laps, the exact overflow count when the
+ * consumer lags, every delivered byte in order, and zero loss at full line rate while the
+ * consumer stays within half a ring (the DMA runs up to half a ring ahead of its last event).
+ *
+ * Build and run (from the repository root), or use Tools/tests/run_tests.sh:
+ *   gcc -O2 -std=gnu11 -Wall -Wextra -IDataLink/Driver -o test_rxring \
+ *       Tools/tests/test_rxring.c DataLink/Driver/DataLink_RxRing.c && ./test_rxring
+ */
+#define _GNU_SOURCE
+
+#include "DataLink_RxRing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_BYTE_US           1042u    /* 10 bits at 9600 baud */
+#define TEST_MASK              (DL_RX_RING_SIZE - 1u)
+
+static unsigned s_failed;
+
+#define CHECK(cond, ...)                                                 \
+    do {                                                                 \
+        if (!(cond))                                                     \
+        {                                                                \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                  \
+            printf(__VA_ARGS__);                                         \
+            printf("\n");                                                \
+            s_failed++;                                                  \
+            return;                                                      \
+        }                                                                \
+    } while (0)
+
+/* Fake circular DMA feeding the ring, publishing like the HAL Rx event callback. */
+typedef struct {
+    dl_rx_ring_t* r;
+    uint16_t      pos;          /* DMA write offset (0..SIZE) */
+    uint16_t      published;    /* offset last passed to the ring, as port->dma_pos */
+    uint32_t      sent;         /* bytes written so far; byte k carries pattern(k) */
+} fake_dma_t;
+
+static uint8_t pattern(uint32_t k)
+{
+    return (uint8_t)(k * 7u + (k >> 8));
+}
+
+static void dma_event(fake_dma_t* d)
+{
+    uint16_t pos = (uint16_t)(d->pos & TEST_MASK);
+
+    dl_rx_ring_commit(d->r, (uint16_t)((pos - d->published) & TEST_MASK));
+    d->published = pos;
+}
+
+/* One byte off the line; half and full transfer raise their events on the way. */
+static void dma_byte(fake_dma_t* d)
+{
+    d->r->buf[d->pos++] = pattern(d->sent++);
+    if (d->pos == DL_RX_RING_SIZE / 2u)
+    {
+        dma_event(d);
+    }
+    else if (d->pos == DL_RX_RING_SIZE)
+    {
+        d->pos = 0u;
+        dma_event(d);
+    }
+}
+
+static void dma_burst(fake_dma_t* d, uint16_t n)
+{
+    while (n--)
+        dma_byte(d);
+    dma_event(d);               /* idle line after the burst */
+}
+
+/* Reads everything available in random chunks; checks the bytes continue the pattern from
+ * '*next', skipping exactly what the ring reports as dropped. */
+static bool drain(dl_rx_ring_t* r, uint32_t* next, uint32_t* dropped_seen)
+{
+    uint8_t  buf[DL_RX_RING_SIZE];
+    uint16_t n;
+
+    *next += r->dropped - *dropped_seen;
+    *dropped_seen = r->dropped;
+
+    do {
+        uint16_t want = (uint16_t)(1u + (uint32_t)rand() % DL_RX_RING_SIZE);
+
+        n = dl_rx_ring_read(r, buf, want);
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            if (buf[i] != pattern(*next))
+                return false;
+            (*next)++;
+        }
+    } while (n != 0u);
+
+    return true;
+}
+
+static void test_wraparound(void)
+{
+    dl_rx_ring_t r;
+    fake_dma_t   d = { &r, 0u, 0u, 0u };
+    uint32_t     next = 0u, seen = 0u;
+
+    dl_rx_ring_reset(&r);
+    for (unsigned lap = 0; lap < 5000u; ++lap)
+    {
+        dma_burst(&d, (uint16_t)(1u + (unsigned)rand() % (DL_RX_RING_SIZE / 2u)));
+        CHECK(drain(&r, &next, &seen), "data out of order at byte %u", (unsigned)next);
+    }
+    CHECK(r.dropped == 0u, "dropped %lu with a consumer that keeps up", (unsigned long)r.dropped);
+    CHECK(next == d.sent, "delivered %u of %u bytes", (unsigned)next, (unsigned)d.sent);
+    printf("ok   wraparound: %u bytes over %u ring laps\n", (unsigned)d.sent, (unsigned)(d.sent / DL_RX_RING_SIZE));
+}
+
+/* Overflow while the consumer lags: each commit adds only the bytes it overwrote. */
+static void test_overflow_count(void)
+{
+    dl_rx_ring_t r;
+    uint8_t      buf[DL_RX_RING_SIZE];
+
+    dl_rx_ring_reset(&r);
+    dl_rx_ring_commit(&r, DL_RX_RING_SIZE + 2u);
+    CHECK(r.dropped == 2u, "first overflow counted %lu, expected 2", (unsigned long)r.dropped);
+    dl_rx_ring_commit(&r, 10u);
+    CHECK(r.dropped == 12u, "second overflow counted %lu, expected 12", (unsigned long)r.dropped);
+    dl_rx_ring_commit(&r, 0u);
+    CHECK(r.dropped == 12u, "empty commit changed the count to %lu", (unsigned long)r.dropped);
+
+    CHECK(dl_rx_ring_read(&r, buf, sizeof buf) == DL_RX_RING_SIZE, "lapped ring must still yield one full ring");
+    dl_rx_ring_commit(&r, DL_RX_RING_SIZE);
+    CHECK(r.dropped == 12u, "a full but not overflowing ring counted %lu", (unsigned long)r.dropped);
+    dl_rx_ring_commit(&r, 1u);
+    CHECK(r.dropped == 13u, "one byte past full counted %lu, expected 13", (unsigned long)r.dropped);
+
+    dl_rx_ring_flush(&r);
+    dl_rx_ring_commit(&r, 5u);
+    CHECK(r.dropped == 13u, "commit after flush counted %lu", (unsigned long)r.dropped);
+    printf("ok   overflow count: 2 + 10 + 1 bytes lost, counted once each\n");
+}
+
+/* Full line rate with the consumer polling every 'poll_ms'. Without loss every byte must
+ * arrive in order; a consumer too slow for the ring must see the loss reported. */
+static void test_line_rate(uint32_t poll_ms, bool expect_loss)
+{
+    dl_rx_ring_t r;
+    fake_dma_t   d = { &r, 0u, 0u, 0u };
+    uint32_t     next = 0u, seen = 0u;
+    uint64_t     t_us = 0u, poll_at = poll_ms * 1000u;
+    uint16_t     frame = 0u;
+
+    dl_rx_ring_reset(&r);
+
+    /* 60 s of back-to-back 96-byte frames, each followed by an idle event */
+    while (t_us < 60000000u)
+    {
+        dma_byte(&d);
+        t_us += TEST_BYTE_US;
+        if (++frame == 96u)
+        {
+            dma_event(&d);
+            frame = 0u;
+        }
+        if (t_us >= poll_at)
+        {
+            bool in_order = drain(&r, &next, &seen);
+
+            CHECK(in_order || expect_loss, "data out of order at byte %u (poll %u ms)", (unsigned)next, (unsigned)poll_ms);
+            poll_at += poll_ms * 1000u;
+        }
+    }
+    dma_event(&d);
+
+    if (expect_loss)
+    {
+        CHECK(r.dropped != 0u, "polling every %u ms must overflow a %u-byte ring", (unsigned)poll_ms, DL_RX_RING_SIZE);
+        printf("ok   line rate, poll every %3u ms: %u bytes, loss reported (%lu dropped)\n", (unsigned)poll_ms,
+               (unsigned)d.sent, (unsigned long)r.dropped);
+        return;
+    }
+
+    CHECK(drain(&r, &next, &seen), "data out of order at the end (poll %u ms)", (unsigned)poll_ms);
+    CHECK(next == d.sent, "sequence ends at %u, %u bytes sent", (unsigned)next, (unsigned)d.sent);
+    CHECK(r.dropped == 0u, "lost %lu bytes polling every %u ms", (unsigned long)r.dropped, (unsigned)poll_ms);
+    printf("ok   line rate, poll every %3u ms: %u bytes, none lost\n", (unsigned)poll_ms, (unsigned)d.sent);
+}
+
+/* Producer + consumer cost per byte on this host, for orders of magnitude only. */
+static void test_throughput(void)
+{
+    dl_rx_ring_t    r;
+    fake_dma_t      d = { &r, 0u, 0u, 0u };
+    uint32_t        next = 0u, seen = 0u;
+    struct timespec a, b;
+    double          s;
+
+    dl_rx_ring_reset(&r);
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (unsigned i = 0; i < 200000u; ++i)
+    {
+        dma_burst(&d, 48u);
+        if (!drain(&r, &next, &seen))
+            break;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    s = (double)(b.tv_sec - a.tv_sec) + (double)(b.tv_nsec - a.tv_nsec) / 1e9;
+
+    CHECK(next == d.sent && r.dropped == 0u, "lost data in the throughput run");
+    printf("ok   throughput: %.1f MB/s through commit + read (line rate 0.00096 MB/s)\n", (double)d.sent / s / 1e6);
+}
+
+int main(void)
+{
+    srand(1u);
+
+    test_wraparound();
+    test_overflow_count();
+    test_line_rate(50u, false);
+    test_line_rate(65u, false);          /* 62 bytes per poll: just inside half a ring */
+    test_line_rate(200u, true);
+    test_throughput();
+
+    printf("%s\n", s_failed ? "FAILED" : "PASSED");
+    return s_failed ? 1 : 0;
+}
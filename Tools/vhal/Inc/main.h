@@ -0,0 +1,97 @@
+#ifndef VHAL_MAIN_H
+#define VHAL_MAIN_H
+
+/* Host stand-in for Core/Inc/main.h: just the slice of the STM32 HAL that DataLink and
+ * DataLink_User use, backed by the virtual clock and UART model in vhal.c. Register and
+ * flag names match the G0 HAL; ICR clear bits sit at the same positions as their ISR flags,
+ * so clearing simply drops the ISR bit. */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t ISR;
+} USART_TypeDef;
+
+typedef struct {
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct {
+    volatile uint32_t CNDTR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    DMA_Channel_TypeDef* Instance;
+} DMA_HandleTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef*     Instance;
+    UART_InitTypeDef   Init;
+    DMA_HandleTypeDef* hdmarx;
+} UART_HandleTypeDef;
+
+#define USART_ISR_PE                (1u << 0)
+#define USART_ISR_FE                (1u << 1)
+#define USART_ISR_NE                (1u << 2)
+#define USART_ISR_ORE               (1u << 3)
+#define USART_ISR_IDLE              (1u << 4)
+#define USART_ISR_RTOF              (1u << 11)
+
+#define UART_CLEAR_PEF              USART_ISR_PE
+#define UART_CLEAR_FEF              USART_ISR_FE
+#define UART_CLEAR_NEF              USART_ISR_NE
+#define UART_CLEAR_OREF             USART_ISR_ORE
+#define UART_CLEAR_IDLEF            USART_ISR_IDLE
+#define UART_CLEAR_RTOF             USART_ISR_RTOF
+#define UART_FLAG_RTOF              USART_ISR_RTOF
+
+#define HAL_MAX_DELAY               0xFFFFFFFFu
+
+/* Single-threaded model: the "interrupts" run inside HAL calls, never in between. */
+#define __disable_irq()             ((void)0)
+#define __enable_irq()              ((void)0)
+#define __get_PRIMASK()             0u
+#define __set_PRIMASK(m)            ((void)(m))
+
+/* SysTick reads back the virtual clock (64 MHz core, 1 kHz tick, as on the board); the
+ * tick interrupt is never seen pending because HAL_GetTick and VAL share one clock. */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSTSET_Msk      (1u << 26)
+
+SysTick_Type*     vhal_systick(void);
+extern SCB_Type   vhal_scb;
+#define SysTick                     (vhal_systick())
+#define SCB                         (&vhal_scb)
+
+#define __HAL_UART_CLEAR_FLAG(h, f) ((h)->Instance->ISR &= ~(uint32_t)(f))
+#define __HAL_UART_GET_FLAG(h, f)   ((((h)->Instance->ISR) & (f)) == (f))
+#define __HAL_DMA_GET_COUNTER(h)    ((h)->Instance->CNDTR)
+
+uint32_t          HAL_GetTick(void);
+void              HAL_Delay(uint32_t Delay);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+void              HAL_UART_ReceiverTimeout_Config(UART_HandleTypeDef* huart, uint32_t TimeoutValue);
+HAL_StatusTypeDef HAL_UART_EnableReceiverTimeout(UART_HandleTypeDef* huart);
+
+/* Implemented by the code under test (DataLink_TransportHal.c). */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+
+#endif /* VHAL_MAIN_H */
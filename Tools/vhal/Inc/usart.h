@@ -0,0 +1,11 @@
+#ifndef VHAL_USART_H
+#define VHAL_USART_H
+
+/* Host stand-in for Core/Inc/usart.h: USART1 talks to the simulated Ocean device,
+ * USART2 (console) goes to stdout. */
+#include "main.h"
+
+extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
+
+#endif /* VHAL_USART_H */
@@ -0,0 +1,343 @@
+#include "vhal.h"
+#include "main.h"
+#include "usart.h"
+#include "DataLink_Driver.h"
+#include <stdio.h>
+
+static USART_TypeDef       s_usart1, s_usart2;
+static DMA_Channel_TypeDef s_dma1_ch;
+static DMA_HandleTypeDef   s_hdma_usart1_rx = { &s_dma1_ch };
+
+UART_HandleTypeDef huart1 = { &s_usart1, { 9600u },   &s_hdma_usart1_rx };
+UART_HandleTypeDef huart2 = { &s_usart2, { 115200u }, NULL };
+
+static uint64_t    s_now_us;
+static ocean_sim_t s_dev;
+static bool        s_echo;
+
+static SysTick_Type s_systick = { 0u, 63999u, 63999u, 0u };
+SCB_Type            vhal_scb;
+
+/* USART1 receive side: circular DMA into the driver's buffer */
+static uint8_t*    s_dma_buf;
+static uint16_t    s_dma_size;
+static uint16_t    s_dma_pos;
+static bool        s_rx_armed;
+static bool        s_burst;             /* bytes received since the last IDLE event */
+static bool        s_rto_armed;
+static uint32_t    s_rto_bits;
+static uint64_t    s_last_rx_us;
+static uint16_t    s_ore_in;            /* device bytes until the injected overrun, 0: none */
+
+/* USART1 transmit side: HAL_UART_Transmit_IT in progress */
+static const uint8_t* s_tx_buf;
+static uint16_t    s_tx_size;
+static uint16_t    s_tx_idx;
+static uint64_t    s_tx_next_us;        /* stop bit of the next byte out */
+static bool        s_tx_busy;
+static uint16_t    s_tx_loaded;         /* bytes written to the UART (shift register + FIFO) */
+static uint8_t     s_tx_fifo = 8u;
+
+/* CPU stalls (vhal_set_cpu_stall) and the interrupts they hold off */
+static uint32_t    s_stall_period_us;
+static uint32_t    s_stall_len_us;
+static bool        s_stall_masked;
+static uint64_t    s_stall_next_us;
+static bool        s_masked;
+static bool        s_rx_event_pending;
+static bool        s_tx_cplt_pending;
+static bool        s_usart_irq_pending;
+
+static uint64_t byte_us(void)
+{
+    return 10000000u / huart1.Init.BaudRate;
+}
+
+/* USART1 Rx event interrupt (IDLE, half/full transfer); with interrupts masked it stays
+ * pending and is then taken once, at the DMA position of that moment. */
+static void rx_event(uint16_t pos)
+{
+    if (s_masked)
+        s_rx_event_pending = true;
+    else
+        HAL_UARTEx_RxEventCallback(&huart1, pos);
+}
+
+/* USART1 error interrupt, held off like the Rx events while interrupts are masked. */
+static void usart_irq(void)
+{
+    if (s_masked)
+        s_usart_irq_pending = true;
+    else
+        dl_rx_irq_handler();
+}
+
+static void rx_byte(uint64_t at, uint8_t b)
+{
+    s_last_rx_us = at;
+    s_rto_armed  = true;
+    if (!s_rx_armed)
+        return;
+
+    /* injected overrun: the byte never reaches the DMA, the line still counts as busy */
+    if (s_ore_in != 0u && --s_ore_in == 0u)
+    {
+        s_burst = true;
+        s_usart1.ISR |= USART_ISR_ORE;
+        usart_irq();
+        return;
+    }
+
+    s_dma_buf[s_dma_pos++] = b;
+    s_burst = true;
+    if (s_dma_pos == s_dma_size / 2u)
+    {
+        rx_event(s_dma_pos);
+    }
+    else if (s_dma_pos == s_dma_size)
+    {
+        s_dma_pos = 0u;
+        s_burst   = false;
+        rx_event(s_dma_size);
+    }
+    s_dma1_ch.CNDTR = (uint32_t)(s_dma_size - s_dma_pos);
+}
+
+/* Runs every host byte, device byte, IDLE and receiver-timeout event up to 't', in time order. */
+static void advance_to(uint64_t t)
+{
+    for (;;)
+    {
+        uint64_t next_byte = ocean_sim_next_us(&s_dev);
+        uint64_t tx_at     = (s_tx_busy && s_tx_idx < s_tx_loaded) ? s_tx_next_us : UINT64_MAX;
+        uint64_t idle_at   = s_burst ? s_last_rx_us + byte_us() : UINT64_MAX;
+        uint64_t rto_at    = (s_rto_armed && s_rto_bits) ? s_last_rx_us + s_rto_bits * (byte_us() / 10u) : UINT64_MAX;
+        uint64_t next      = next_byte;
+
+        if (tx_at < next)
+            next = tx_at;
+        if (idle_at < next)
+            next = idle_at;
+        if (rto_at < next)
+            next = rto_at;
+        if (next > t)
+            break;
+
+        s_now_us = next;
+        if (next == tx_at)
+        {
+            /* each byte reaches the device once its stop bit is out; TC after the last */
+            ocean_sim_rx(&s_dev, next, &s_tx_buf[s_tx_idx++], 1u);
+            s_tx_next_us += byte_us();
+            if (s_tx_idx == s_tx_size)
+            {
+                s_tx_busy = false;
+                if (s_masked)
+                    s_tx_cplt_pending = true;
+                else
+                    HAL_UART_TxCpltCallback(&huart1);
+            }
+        }
+        else if (next == next_byte)
+        {
+            uint8_t b;
+            (void)ocean_sim_tx(&s_dev, next, &b, 1u);
+            rx_byte(next, b);
+        }
+        else if (next == idle_at)
+        {
+            s_burst = false;
+            if (s_rx_armed)
+                rx_event(s_dma_pos);
+        }
+        else
+        {
+            s_rto_armed = false;
+            s_usart1.ISR |= USART_ISR_RTOF;
+        }
+    }
+    s_now_us = t;
+}
+
+void vhal_init(const ocean_sim_cfg_t* dev_cfg)
+{
+    s_now_us    = 0u;
+    s_rx_armed  = false;
+    s_burst     = false;
+    s_rto_armed = false;
+    s_tx_busy   = false;
+    s_masked    = false;
+    s_rx_event_pending  = false;
+    s_tx_cplt_pending   = false;
+    s_usart_irq_pending = false;
+    s_ore_in            = 0u;
+    s_stall_next_us     = s_stall_period_us;
+    s_usart1.ISR = 0u;
+    ocean_sim_init(&s_dev, dev_cfg);
+}
+
+uint64_t vhal_now_us(void)
+{
+    return s_now_us;
+}
+
+ocean_sim_t* vhal_device(void)
+{
+    return &s_dev;
+}
+
+void vhal_console(bool echo)
+{
+    s_echo = echo;
+}
+
+/* =============================================================================
+ * HAL surface
+ * ===========================================================================*/
+void vhal_set_tx_fifo(uint8_t depth)
+{
+    s_tx_fifo = (depth != 0u) ? depth : 1u;
+}
+
+void vhal_set_cpu_stall(uint32_t period_us, uint32_t len_us, bool masked)
+{
+    s_stall_period_us = period_us;
+    s_stall_len_us    = len_us;
+    s_stall_masked    = masked;
+    s_stall_next_us   = s_now_us + period_us;
+}
+
+void vhal_inject_overrun(uint16_t nth)
+{
+    s_ore_in = nth;
+}
+
+/* The main thread is held for one stall. With interrupts masked the Tx side only sends what
+ * is already in the UART: the byte in the shift register plus the FIFO at its refill level
+ * (worst case: half full with FIFO mode, the empty data register without). */
+static void cpu_stall(void)
+{
+    if (s_stall_masked)
+    {
+        uint32_t ahead = 1u + ((s_tx_fifo > 1u) ? s_tx_fifo / 2u : 0u);
+
+        s_masked = true;
+        if (s_tx_busy)
+            s_tx_loaded = (uint16_t)((s_tx_idx + ahead < s_tx_size) ? s_tx_idx + ahead : s_tx_size);
+    }
+
+    advance_to(s_now_us + s_stall_len_us);
+    s_masked = false;
+
+    /* pending interrupts are taken as soon as the mask is lifted */
+    if (s_tx_busy && s_tx_loaded < s_tx_size)
+    {
+        if (s_tx_idx == s_tx_loaded)
+            s_tx_next_us = s_now_us + byte_us();        /* line went idle: restart */
+        s_tx_loaded = s_tx_size;
+    }
+    if (s_tx_cplt_pending)
+    {
+        s_tx_cplt_pending = false;
+        HAL_UART_TxCpltCallback(&huart1);
+    }
+    if (s_usart_irq_pending)
+    {
+        s_usart_irq_pending = false;
+        dl_rx_irq_handler();
+    }
+    if (s_rx_event_pending)
+    {
+        s_rx_event_pending = false;
+        if (s_rx_armed)
+            HAL_UARTEx_RxEventCallback(&huart1, s_dma_pos);
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    advance_to(s_now_us + VHAL_POLL_COST_US);
+    if (s_stall_len_us != 0u && s_now_us >= s_stall_next_us)
+    {
+        s_stall_next_us = s_now_us + s_stall_period_us;
+        cpu_stall();
+    }
+    return (uint32_t)(s_now_us / 1000u);
+}
+
+SysTick_Type* vhal_systick(void)
+{
+    s_systick.VAL = s_systick.LOAD - (uint32_t)(s_now_us % 1000u) * ((s_systick.LOAD + 1u) / 1000u);
+    return &s_systick;
+}
+
+/* Like the HAL: at least 'Delay' ms, plus one tick. */
+void HAL_Delay(uint32_t Delay)
+{
+    advance_to(s_now_us + ((uint64_t)Delay + 1u) * 1000u);
+}
+
+/* USART1 bytes go out as virtual time advances; the console completes at once. */
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size)
+{
+    if (huart != &huart1)
+    {
+        if (s_echo)
+            (void)fwrite(pData, 1u, Size, stdout);
+        HAL_UART_TxCpltCallback(huart);
+        return HAL_OK;
+    }
+
+    if (s_tx_busy)
+        return HAL_BUSY;
+    if (Size == 0u)
+        return HAL_ERROR;
+
+    s_tx_buf     = pData;
+    s_tx_size    = Size;
+    s_tx_idx     = 0u;
+    s_tx_next_us = s_now_us + byte_us();
+    s_tx_loaded  = Size;
+    s_tx_busy    = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef* huart)
+{
+    if (huart == &huart1)
+        s_tx_busy = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart)
+{
+    if (huart == &huart1)
+        s_rx_armed = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)
+{
+    if (huart != &huart1)
+        return HAL_ERROR;
+
+    s_dma_buf       = pData;
+    s_dma_size      = Size;
+    s_dma_pos       = 0u;
+    s_burst         = false;
+    s_rx_armed      = true;
+    s_dma1_ch.CNDTR = Size;
+    return HAL_OK;
+}
+
+void HAL_UART_ReceiverTimeout_Config(UART_HandleTypeDef* huart, uint32_t TimeoutValue)
+{
+    if (huart == &huart1)
+        s_rto_bits = TimeoutValue;
+}
+
+HAL_StatusTypeDef HAL_UART_EnableReceiverTimeout(UART_HandleTypeDef* huart)
+{
+    (void)huart;
+    return HAL_OK;
+}
@@ -0,0 +1,50 @@
+#ifndef VHAL_H
+#define VHAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ocean_sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Virtual-time HAL: a discrete-event clock in microseconds. HAL_Delay jumps the clock,
+ * HAL_GetTick charges VHAL_POLL_COST_US per call (so polling loops make progress), and
+ * HAL_UART_Transmit_IT on USART1 sends one byte per character time at the configured baud
+ * rate, raising the Tx-complete callback after the last (console output completes at once).
+ * Device bytes reach the DMA ring at their simulated arrival times, with the IDLE, half/full
+ * transfer and receiver-timeout events a real USART would raise. */
+
+#define VHAL_POLL_COST_US      1u       /* simulated cost of one HAL_GetTick() */
+
+/* Resets the clock to 0 and powers on a simulated device on USART1 (9600 baud). */
+void         vhal_init(const ocean_sim_cfg_t* dev_cfg);
+
+uint64_t     vhal_now_us(void);
+ocean_sim_t* vhal_device(void);
+
+/* Console output (USART2) to stdout; off by default. */
+void         vhal_console(bool echo);
+
+/* USART1 Tx FIFO depth: 8 (FIFO mode, as configured on the board, the default) or 1 (the
+ * single data register). Only matters while interrupts are masked. */
+void         vhal_set_tx_fifo(uint8_t depth);
+
+/* CPU stalls: every 'period_us' the main thread is held for 'len_us' inside the HAL call it
+ * is making. With 'masked' the UART interrupts are held off as well: Rx events wait (the
+ * DMA keeps receiving) and the Tx side stops once the UART has sent what it holds.
+ * 'len_us' = 0 disables. Set before vhal_init() or at any time after. */
+void         vhal_set_cpu_stall(uint32_t period_us, uint32_t len_us, bool masked);
+
+/* Receive overrun: the 'nth' device byte from now (1 = the next one) is lost as if the DMA
+ * had not emptied the receiver in time. ORE is set and the USART1 interrupt runs the
+ * driver's hook (dl_rx_irq_handler, as USART1_IRQHandler does), held off while interrupts
+ * are masked. Fires once; 0 cancels. */
+void         vhal_inject_overrun(uint16_t nth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VHAL_H */
@@ -0,0 +1,161 @@
+/* vhal_bench - latency benchmark of every DataLink_User operation in virtual time.
+ *
+ * Runs each public function of DataLink_User.h for many iterations against the simulated
+ * Ocean device, in three scenarios: a clean link, 1 % response-byte loss, and a device that
+ * stalls for a while after every reconfiguration (then sends its own RESET). Each scenario
+ * runs in a fresh process, so driver and device state start from power-on. Output is one
+ * CSV row per (scenario, operation): success count, p50/p95/p99/max simulated latency in
+ * ms, and DataLink frames exchanged per call (requests + responses, as seen by the device).
+ *
+ * Build: as vhal_run (see vhal_run.c), with Tools/vhal/vhal_bench.c instead of vhal_run.c.
+ * Usage: vhal_bench [-n iterations] [-s seed]
+ */
+#define _GNU_SOURCE
+
+#include "vhal.h"
+#include "DataLink_Driver.h"
+#include "DataLink_User.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BENCH_MAX_ITERS        1000u
+
+typedef struct {
+    const char* name;
+    uint32_t    drop_ppm;
+    uint32_t    stall_ms;
+} scenario_t;
+
+static const scenario_t k_scenarios[] = {
+    { "clean",    0u,     0u   },
+    { "loss1pct", 10000u, 0u   },
+    { "stall",    0u,     150u },
+};
+
+/* Setters alternate their argument so every call really changes the device. */
+static bool op_set_channels(unsigned i)   { return SetChannels((uint8_t)(1u + i % 4u)); }
+static bool op_read_channels(unsigned i)  { uint8_t c; (void)i; return ReadChannels(&c); }
+static bool op_set_power(unsigned i)      { return SetPower((i & 1u) ? 0.5f : 1.0f); }
+static bool op_change_power(unsigned i)   { return ChangePower((i & 1u) ? 0.625f : 0.875f); }
+static bool op_read_power(unsigned i)     { float w; (void)i; return ReadPower(&w); }
+static bool op_read_config(unsigned i)    { uint8_t c; float w; (void)i; return ReadConfig(&c, &w); }
+static bool op_set_config(unsigned i)     { return SetConfig((uint8_t)(1u + i % 4u), (i & 1u) ? 0.5f : 0.75f); }
+static bool op_write_output(unsigned i)   { return WriteOutputState((uint8_t)(i & 1u)); }
+static bool op_read_output(unsigned i)    { uint8_t s; (void)i; return ReadOutputState(&s); }
+static bool op_write_default(unsigned i)  { return WriteDefaultState((uint8_t)(i & 1u)); }
+static bool op_read_default(unsigned i)   { uint8_t s; (void)i; return ReadDefaultState(&s); }
+static bool op_read_errorflag(unsigned i) { uint32_t f; (void)i; return ReadErrorflag(&f); }
+static bool op_reset_error(unsigned i)    { (void)i; return ResetError(); }
+static bool op_read_data(unsigned i)      { (void)i; return ReadData(); }
+
+static const struct {
+    const char* name;
+    bool      (*run)(unsigned i);
+} k_ops[] = {
+    { "SetChannels",       op_set_channels },
+    { "ReadChannels",      op_read_channels },
+    { "SetPower",          op_set_power },
+    { "ChangePower",       op_change_power },
+    { "ReadPower",         op_read_power },
+    { "ReadConfig",        op_read_config },
+    { "SetConfig",         op_set_config },
+    { "WriteOutputState",  op_write_output },
+    { "ReadOutputState",   op_read_output },
+    { "WriteDefaultState", op_write_default },
+    { "ReadDefaultState",  op_read_default },
+    { "ReadErrorflag",     op_read_errorflag },
+    { "ResetError",        op_reset_error },
+    { "ReadData",          op_read_data },
+};
+
+static int cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t pct(const uint64_t* v, unsigned n, unsigned p)
+{
+    unsigned i = (n * p) / 100u;
+    return v[(i < n) ? i : n - 1u];
+}
+
+static void run_scenario(const scenario_t* sc, unsigned iters, uint32_t seed)
+{
+    ocean_sim_cfg_t cfg = { .baud = 9600u, .latency_us = 3000u, .seed = seed, .require_unlock = true,
+                            .drop_ppm = sc->drop_ppm, .stall_us = sc->stall_ms * 1000u,
+                            .reset_after_stall = sc->stall_ms != 0u };
+    static uint64_t lat[BENCH_MAX_ITERS];
+
+    vhal_init(&cfg);
+    dl_rx_start();
+    (void)dl_handshake();
+
+    for (size_t k = 0; k < sizeof k_ops / sizeof k_ops[0]; ++k)
+    {
+        const ocean_sim_stats_t* st     = &vhal_device()->stats;
+        uint32_t                 frames = st->frames_rx + st->frames_tx;
+        unsigned                 ok     = 0u;
+
+        for (unsigned i = 0; i < iters; ++i)
+        {
+            uint64_t t0 = vhal_now_us();
+            if (k_ops[k].run(i))
+                ok++;
+            lat[i] = vhal_now_us() - t0;
+        }
+        frames = st->frames_rx + st->frames_tx - frames;
+
+        qsort(lat, iters, sizeof lat[0], cmp_u64);
+        printf("%s,%s,%u,%u,%.3f,%.3f,%.3f,%.3f,%.2f\n", sc->name, k_ops[k].name, iters, ok,
+               (double)pct(lat, iters, 50u) / 1000.0, (double)pct(lat, iters, 95u) / 1000.0,
+               (double)pct(lat, iters, 99u) / 1000.0, (double)lat[iters - 1u] / 1000.0,
+               (double)frames / (double)iters);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned iters = 50u;
+    uint32_t seed  = 1u;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': iters = (unsigned)strtoul(optarg, NULL, 0); break;
+            case 's': seed  = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (iters == 0u || iters > BENCH_MAX_ITERS)
+    {
+        fprintf(stderr, "iterations: 1..%u\n", BENCH_MAX_ITERS);
+        return 2;
+    }
+
+    printf("scenario,op,iters,ok,p50_ms,p95_ms,p99_ms,max_ms,frames_per_call\n");
+    fflush(stdout);
+
+    for (size_t s = 0; s < sizeof k_scenarios / sizeof k_scenarios[0]; ++s)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            run_scenario(&k_scenarios[s], iters, seed);
+            _exit(0);
+        }
+        if (pid < 0 || waitpid(pid, NULL, 0) < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* vhal_run - runs DataLink_User operations against a simulated Ocean device in virtual time.
+ *
+ * The firmware sources (driver, HAL transport, DataLink_User) are compiled unchanged against
+ * the host HAL in this directory; every HAL_Delay and deadline loop costs no wall time. Each
+ * operation's simulated duration is exact and repeatable for a given device configuration.
+ *
+ * Build (from the repository root):
+ *   gcc -O2 -std=gnu11 -ITools/vhal/Inc -ITools/vhal -ITools/ocean_sim \
+ *       -IDataLink/Driver -IDataLink/HAL -IDataLink/User -o vhal_run \
+ *       Tools/vhal/vhal_run.c Tools/vhal/vhal.c Tools/ocean_sim/ocean_sim.c \
+ *       DataLink/Driver/DataLink_Driver.c DataLink/Driver/DataLink_Crc.c \
+ *       DataLink/Driver/DataLink_RxRing.c DataLink/Driver/DataLink_Trace.c \
+ *       DataLink/HAL/DataLink_TransportHal.c DataLink/HAL/DataLink_HAL.c \
+ *       DataLink/User/DataLink_User.c -lm
+ *
+ * Usage: vhal_run [-L latency_us] [-J jitter_us] [-S stall_ms] [-D drop_ppm] [-C corrupt_ppm]
+ *                 [-s seed] [-u] [-R] [-v]
+ *   Device options as for ocean_sim; -v echoes the console (USART2) output.
+ *   Prints one CSV row per operation: simulated ms and wall-clock us.
+ */
+#define _GNU_SOURCE
+
+#include "vhal.h"
+#include "DataLink_Driver.h"
+#include "DataLink_User.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t wall_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static uint8_t s_channels;
+static float   s_watts;
+
+static bool op_handshake(void)      { return dl_handshake(); }
+static bool op_read_config(void)    { return ReadConfig(&s_channels, &s_watts); }
+static bool op_set_channels(void)   { return SetChannels(2u); }
+static bool op_set_power(void)      { return SetPower(0.75f); }
+static bool op_set_config(void)     { return SetConfig(3u, 0.625f); }
+static bool op_change_power(void)   { return ChangePower(0.875f); }
+static bool op_read_power(void)     { return ReadPower(&s_watts); }
+static bool op_read_data(void)      { return ReadData(); }
+
+static const struct {
+    const char* name;
+    bool      (*run)(void);
+} k_ops[] = {
+    { "dl_handshake",      op_handshake },
+    { "ReadConfig",        op_read_config },
+    { "SetChannels(2)",    op_set_channels },
+    { "SetPower(0.75)",    op_set_power },
+    { "SetConfig(3,0.625)", op_set_config },
+    { "ChangePower(0.875)", op_change_power },
+    { "ReadPower",         op_read_power },
+    { "ReadData",          op_read_data },
+};
+
+int main(int argc, char** argv)
+{
+    ocean_sim_cfg_t cfg = { .baud = 9600u, .latency_us = 3000u, .seed = 1u, .require_unlock = true };
+    int             opt;
+
+    while ((opt = getopt(argc, argv, "L:J:S:D:C:s:uRv")) != -1)
+    {
+        switch (opt)
+        {
+            case 'L': cfg.latency_us        = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'J': cfg.jitter_us         = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'S': cfg.stall_us          = (uint32_t)strtoul(optarg, NULL, 0) * 1000u;  break;
+            case 'D': cfg.drop_ppm          = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'C': cfg.corrupt_ppm       = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 's': cfg.seed              = (uint32_t)strtoul(optarg, NULL, 0);          break;
+            case 'u': cfg.require_unlock    = false;                                       break;
+            case 'R': cfg.reset_after_stall = true;                                        break;
+            case 'v': vhal_console(true);                                                  break;
+            default:
+                fprintf(stderr, "usage: %s [-L latency_us] [-J jitter_us] [-S stall_ms] [-D drop_ppm]"
+                                " [-C corrupt_ppm] [-s seed] [-u] [-R] [-v]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    vhal_init(&cfg);
+    dl_rx_start();
+
+    printf("op,ok,sim_ms,wall_us\n");
+    for (size_t i = 0; i < sizeof k_ops / sizeof k_ops[0]; ++i)
+    {
+        uint64_t t0 = vhal_now_us();
+        uint64_t w0 = wall_us();
+        bool     ok = k_ops[i].run();
+
+        printf("%s,%d,%.3f,%llu\n", k_ops[i].name, ok ? 1 : 0, (double)(vhal_now_us() - t0) / 1000.0,
+               (unsigned long long)(wall_us() - w0));
+    }
+
+    const ocean_sim_stats_t* st = &vhal_device()->stats;
+    printf("# device: rx %u tx %u crc_err %u ignored %u rejected %u dropped %u corrupted %u\n",
+           st->frames_rx, st->frames_tx, st->crc_errors, st->ignored, st->rejected, st->dropped, st->corrupted);
+    return 0;
+}
@@ -0,0 +1,169 @@
+/* vhal_stress - how much CPU latency the DataLink tolerates, in virtual time.
+ *
+ * Runs alternating full-size READs (DL_MAX_READ bytes) and WRITEs (DL_MAX_WRITE bytes)
+ * through the *_retry calls while the CPU stalls periodically, for growing stall lengths.
+ * Two kinds of stall: "thread" holds only the main loop (interrupts keep running), "masked"
+ * also holds off the UART interrupts, so Rx events wait and interrupt-driven transmit stops
+ * once the UART has sent what it holds. Masked stalls run with the USART1 Tx FIFO enabled
+ * (8 deep, the board configuration) and disabled (1) for comparison. Every point runs in a
+ * fresh process. Output is one CSV row per point: calls that succeeded, calls that needed
+ * no retry, the driver's retry / overrun / timeout / CRC counters, p50 and max latency in ms.
+ * A summary line per series gives the longest stall with every call clean on first try.
+ *
+ * Build: as vhal_run (see vhal_run.c), with Tools/vhal/vhal_stress.c instead of vhal_run.c.
+ * Usage: vhal_stress [-n calls per point] [-p stall period ms] [-s seed]
+ */
+#define _GNU_SOURCE
+
+#include "vhal.h"
+#include "DataLink_Driver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define STRESS_MAX_CALLS       1000u
+#define STRESS_ADDR_READ       0x0100u  /* any readable span of DL_MAX_READ bytes */
+#define STRESS_ADDR_WRITE      0x8200u  /* scratch registers outside the protected range */
+
+typedef struct {
+    const char* name;
+    bool        masked;
+    uint8_t     fifo;
+} series_t;
+
+static const series_t k_series[] = {
+    { "thread",        false, 8u },
+    { "masked_fifo8",  true,  8u },
+    { "masked_fifo1",  true,  1u },
+};
+
+static const uint32_t k_stall_ms[] = { 0u, 1u, 2u, 5u, 10u, 15u, 20u, 25u, 30u, 40u, 50u, 75u, 100u, 150u, 200u };
+
+static int cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Runs one point; returns true if every call succeeded without a retry. */
+static bool run_point(const series_t* se, uint32_t stall_ms, uint32_t period_ms, unsigned calls, uint32_t seed)
+{
+    ocean_sim_cfg_t    cfg = { .baud = 9600u, .latency_us = 3000u, .seed = seed };
+    static uint64_t    lat[STRESS_MAX_CALLS];
+    uint8_t            rb[DL_MAX_READ];
+    uint8_t            wb[DL_MAX_WRITE];
+    dl_link_counters_t c;
+    unsigned           ok = 0u, clean = 0u;
+
+    vhal_set_tx_fifo(se->fifo);
+    vhal_set_cpu_stall(0u, 0u, false);
+    vhal_init(&cfg);
+    dl_rx_start();
+    (void)dl_handshake();
+    dl_reset_counters();
+
+    /* stalls start once the link is up; their phase drifts against the calls */
+    vhal_set_cpu_stall((period_ms + stall_ms) * 1000u, stall_ms * 1000u, se->masked);
+
+    for (unsigned i = 0; i < calls; ++i)
+    {
+        uint32_t    retries = (dl_get_counters(&c), c.retries);
+        uint64_t    t0      = vhal_now_us();
+        dl_status_t st;
+
+        if (i & 1u)
+        {
+            memset(wb, (int)i, sizeof wb);
+            st = dl_write_retry(STRESS_ADDR_WRITE, DL_MAX_WRITE, wb);
+        }
+        else
+        {
+            st = dl_read_retry(STRESS_ADDR_READ, DL_MAX_READ, rb);
+        }
+        lat[i] = vhal_now_us() - t0;
+
+        dl_get_counters(&c);
+        if (st == DL_OK)
+        {
+            ok++;
+            if (c.retries == retries)
+                clean++;
+        }
+    }
+    vhal_set_cpu_stall(0u, 0u, false);
+    dl_get_counters(&c);
+
+    qsort(lat, calls, sizeof lat[0], cmp_u64);
+    printf("%s,%u,%u,%u,%u,%lu,%lu,%lu,%lu,%.3f,%.3f\n", se->name, (unsigned)stall_ms, calls, ok, clean,
+           (unsigned long)c.retries, (unsigned long)c.overruns, (unsigned long)(c.hdr_timeouts + c.pay_timeouts),
+           (unsigned long)c.crc_fail, (double)lat[calls / 2u] / 1000.0, (double)lat[calls - 1u] / 1000.0);
+    fflush(stdout);
+
+    return clean == calls;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned calls     = 40u;
+    uint32_t period_ms = 50u;
+    uint32_t seed      = 1u;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:p:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': calls     = (unsigned)strtoul(optarg, NULL, 0); break;
+            case 'p': period_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': seed      = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-n calls per point] [-p stall period ms] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (calls == 0u || calls > STRESS_MAX_CALLS)
+    {
+        fprintf(stderr, "calls: 1..%u\n", STRESS_MAX_CALLS);
+        return 2;
+    }
+
+    printf("series,stall_ms,calls,ok,first_try,retries,overruns,timeouts,crc_fail,p50_ms,max_ms\n");
+    fflush(stdout);
+
+    for (size_t s = 0; s < sizeof k_series / sizeof k_series[0]; ++s)
+    {
+        int32_t tolerated = -1;
+        bool    broken    = false;
+
+        for (size_t k = 0; k < sizeof k_stall_ms / sizeof k_stall_ms[0]; ++k)
+        {
+            pid_t pid;
+            int   status;
+
+            fflush(stdout);
+            pid = fork();
+
+            if (pid == 0)
+                _exit(run_point(&k_series[s], k_stall_ms[k], period_ms, calls, seed) ? 0 : 1);
+            if (pid < 0 || waitpid(pid, &status, 0) < 0)
+            {
+                perror("fork");
+                return 1;
+            }
+            if (!broken && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+                tolerated = (int32_t)k_stall_ms[k];
+            else
+                broken = true;
+        }
+
+        if (tolerated < 0)
+            printf("# %s: not clean even without stalls\n", k_series[s].name);
+        else
+            printf("# %s: clean up to %ld ms stalls every %lu ms\n", k_series[s].name, (long)tolerated,
+                   (unsigned long)(period_ms + (uint32_t)tolerated));
+        fflush(stdout);
+    }
+    return 0;
+}
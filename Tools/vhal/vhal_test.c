@@ -0,0 +1,686 @@
+/* vhal_test - DataLink driver scenarios in virtual time, with pass/fail checks.
+ *
+ * Every case runs in a fresh process against the simulated Ocean device (power-on state,
+ * 9600 baud, 3 ms latency unless the case changes it), prints one "ok" line with what it
+ * measured or a "FAIL" line per broken check, and the exit status is non-zero if any case
+ * failed. Tools/tests/run_tests.sh builds and runs it with the other host tests.
+ *
+ * Build: as vhal_run (see vhal_run.c), with Tools/vhal/vhal_test.c instead of vhal_run.c.
+ * Usage: vhal_test [case...]      (every case without arguments)
+ */
+#define _GNU_SOURCE
+
+#include "vhal.h"
+#include "DataLink_Driver.h"
+#include "DataLink_Trace.h"
+#include "DataLink_TransportHal.h"
+#include "Ocean_Registers.h"
+#include "main.h"                 /* HAL_GetTick, HAL_Delay, HAL_UART_ErrorCallback */
+#include "usart.h"                /* huart1 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_ADDR_SCRATCH      0x8200u  /* writable registers outside the protected range */
+#define TEST_ADDR_PRODUCT_ID   0x0010u  /* U32, 0x0000C0DE on the simulated device */
+
+#define CHECK(cond, ...)                                                 \
+    do {                                                                 \
+        if (!(cond))                                                     \
+        {                                                                \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                  \
+            printf(__VA_ARGS__);                                         \
+            printf("\n");                                                \
+            return false;                                                \
+        }                                                                \
+    } while (0)
+
+static const ocean_sim_cfg_t k_dev = { .baud = 9600u, .latency_us = 3000u, .seed = 1u };
+
+/* Power-on device and driver, link up. */
+static bool start(const ocean_sim_cfg_t* cfg)
+{
+    vhal_init(cfg);
+    dl_rx_start();
+    if (!dl_handshake())
+        return false;
+    dl_reset_counters();
+    return true;
+}
+
+static double ms_since(uint64_t t0_us)
+{
+    return (double)(vhal_now_us() - t0_us) / 1000.0;
+}
+
+/* =============================================================================
+ * interleave - two clients share the async queue; each re-submits from its callback
+ * ===========================================================================*/
+#define IL_OPS                 40u      /* per client: WRITE i, READ it back, ... */
+#define IL_BLOCKING_MAX_MS     150u     /* a blocking call waits for at most the two ops ahead of it */
+
+typedef struct {
+    char        name;
+    uint16_t    addr;           /* the client's own scratch register */
+    unsigned    next;           /* ops submitted */
+    unsigned    done;           /* ops completed */
+    uint8_t     wval[IL_OPS];
+    uint8_t     rval[IL_OPS];
+    dl_status_t st[IL_OPS];
+    unsigned    ticket[IL_OPS]; /* global submission order */
+    bool        refused;        /* a submit returned an error */
+} il_client_t;
+
+static unsigned s_il_submitted;
+static unsigned s_il_completed;
+static bool     s_il_fifo = true;
+
+static void il_submit(il_client_t* c);
+
+static void il_done(dl_status_t st, void* ctx)
+{
+    il_client_t* c = (il_client_t*)ctx;
+    unsigned     i = c->done++;
+
+    c->st[i] = st;
+    if (c->ticket[i] != s_il_completed++)
+        s_il_fifo = false;
+    if (c->next < IL_OPS)
+        il_submit(c);
+}
+
+/* Even ops write a fresh value to the client's register, odd ops read it back. */
+static void il_submit(il_client_t* c)
+{
+    unsigned    i = c->next++;
+    dl_status_t st;
+
+    c->ticket[i] = s_il_submitted++;
+    if ((i & 1u) == 0u)
+    {
+        c->wval[i] = (uint8_t)(c->name + i);
+        st = dl_write_async(c->addr, 1u, &c->wval[i], il_done, c);
+    }
+    else
+    {
+        st = dl_read_async(c->addr, 1u, &c->rval[i], il_done, c);
+    }
+    if (st != DL_OK)
+        c->refused = true;
+}
+
+static bool case_interleave(void)
+{
+    static il_client_t a = { .name = 'A', .addr = TEST_ADDR_SCRATCH };
+    static il_client_t b = { .name = 'B', .addr = TEST_ADDR_SCRATCH + 1u };
+    uint8_t            pid[4];
+    uint64_t           t0;
+    unsigned           blocking = 0u;
+    double             worst    = 0.0;
+
+    CHECK(start(&k_dev), "handshake failed");
+    t0 = vhal_now_us();
+
+    /* A and B each keep one op queued, submitted alternately */
+    il_submit(&a);
+    il_submit(&b);
+
+    /* a third, blocking client cuts in every 16 completions; it waits its turn in the queue */
+    while (a.done < IL_OPS || b.done < IL_OPS)
+    {
+        (void)dl_poll();
+        if (s_il_completed / 16u > blocking)
+        {
+            uint64_t t1 = vhal_now_us();
+
+            blocking++;
+            CHECK(dl_read(TEST_ADDR_PRODUCT_ID, 4u, pid, DL_WAIT_AUTO, DL_WAIT_AUTO) == DL_OK, "blocking read failed");
+            CHECK(pid[0] == 0xDEu && pid[1] == 0xC0u, "blocking read returned %02X%02X", pid[1], pid[0]);
+            if (ms_since(t1) > worst)
+                worst = ms_since(t1);
+        }
+        CHECK(vhal_now_us() - t0 < 60000000u, "stuck: A %u/%u, B %u/%u done", a.done, IL_OPS, b.done, IL_OPS);
+    }
+    while (dl_poll())
+    {
+    }
+
+    CHECK(!a.refused && !b.refused, "a submit was refused");
+    CHECK(s_il_fifo, "completions left submission order");
+    CHECK(blocking == 2u * IL_OPS / 16u, "%u blocking reads ran, expected %u", blocking, 2u * IL_OPS / 16u);
+    CHECK(worst < IL_BLOCKING_MAX_MS, "a blocking read took %.1f ms", worst);
+    for (unsigned i = 0; i < IL_OPS; ++i)
+    {
+        CHECK(a.st[i] == DL_OK && b.st[i] == DL_OK, "op %u: A status %d, B status %d", i, a.st[i], b.st[i]);
+        if (i & 1u)
+        {
+            CHECK(a.rval[i] == a.wval[i - 1u], "A read %u back as %u", a.wval[i - 1u], a.rval[i]);
+            CHECK(b.rval[i] == b.wval[i - 1u], "B read %u back as %u", b.wval[i - 1u], b.rval[i]);
+        }
+    }
+
+    printf("ok   interleave: 2 x %u async ops + %u blocking reads in submission order, %.1f ms "
+           "(blocking read <= %.1f ms)\n", IL_OPS, blocking, ms_since(t0), worst);
+    return true;
+}
+
+/* =============================================================================
+ * rtt_rise - the device slows down after the estimate has settled on a fast link.
+ * The first call's attempts (20, 40, 80 ms) all expire before the slower answer; the
+ * backoff they leave behind must carry every later call through, and the estimate rise.
+ * ===========================================================================*/
+#define RR_WARMUP              20u      /* calls at 3 ms latency */
+#define RR_CALLS               20u      /* calls at the raised latency */
+#define RR_LATENCY_US          150000u
+
+static bool case_rtt_rise(void)
+{
+    uint8_t            pid[4];
+    dl_rtt_info_t      before, after;
+    dl_link_counters_t c;
+    unsigned           ok = 0u, first_try = 0u, later_fail = 0u;
+    uint64_t           t0;
+
+    CHECK(start(&k_dev), "handshake failed");
+    for (unsigned i = 0; i < RR_WARMUP; ++i)
+        CHECK(dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) == DL_OK, "warm-up read %u failed", i);
+    (void)dl_rtt_query(DL_TYPE_READ, 4u, &before);
+
+    vhal_device()->cfg.latency_us = RR_LATENCY_US;
+    dl_reset_counters();
+    t0 = vhal_now_us();
+    for (unsigned i = 0; i < RR_CALLS; ++i)
+    {
+        uint32_t retries = (dl_get_counters(&c), c.retries);
+
+        if (dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) == DL_OK && pid[0] == 0xDEu && pid[1] == 0xC0u)
+        {
+            ok++;
+            first_try += (dl_get_counters(&c), c.retries == retries);
+        }
+        else if (i > 0u)
+        {
+            later_fail++;
+        }
+    }
+    (void)dl_rtt_query(DL_TYPE_READ, 4u, &after);
+    dl_get_counters(&c);
+
+    CHECK(before.hdr_timeout_ms < RR_LATENCY_US / 1000u, "warm-up left a %u ms deadline", before.hdr_timeout_ms);
+    CHECK(later_fail == 0u, "%u calls after the first failed at %u ms latency", later_fail, RR_LATENCY_US / 1000u);
+    CHECK(after.hdr_timeout_ms > RR_LATENCY_US / 1000u, "header deadline stayed at %u ms", after.hdr_timeout_ms);
+    CHECK(after.hdr_srtt_ms >= before.hdr_srtt_ms + 50u, "srtt only moved from %u to %u ms", before.hdr_srtt_ms,
+          after.hdr_srtt_ms);
+    CHECK(first_try + 1u >= ok, "only %u of %u successful calls clean on first try", first_try, ok);
+
+    printf("ok   rtt_rise: latency 3 -> %u ms, %u of %u calls ok (%u first try, %lu timeouts) in %.1f ms; "
+           "header srtt %u -> %u ms, deadline %u -> %u ms\n", RR_LATENCY_US / 1000u, ok, RR_CALLS, first_try,
+           (unsigned long)(c.hdr_timeouts + c.pay_timeouts), ms_since(t0), before.hdr_srtt_ms, after.hdr_srtt_ms,
+           before.hdr_timeout_ms, after.hdr_timeout_ms);
+    return true;
+}
+
+/* =============================================================================
+ * recovery - time-to-recover for each tier of the tiered recovery, against the former
+ * policy of a full handshake after every failure. The device ignores every request
+ * (resets included) for a while; the time runs from the fault to the first good response.
+ * ===========================================================================*/
+#define RC_MAX_CALLS           8u       /* calls before a fault counts as unrecovered */
+
+typedef struct {
+    double   ms;
+    unsigned calls;
+    uint32_t retries;
+    uint32_t quick;
+    uint32_t full;
+} rc_result_t;
+
+/* Reads until one succeeds; 'tiered' uses dl_read_retry, otherwise one attempt and a full
+ * handshake after each failure. */
+static bool rc_run(uint32_t stall_ms, bool tiered, rc_result_t* r)
+{
+    uint8_t            pid[4];
+    dl_link_counters_t c;
+    uint64_t           t0;
+    dl_status_t        st = DL_ERR_TIMEOUT;
+
+    /* a few clean reads: fresh RTT samples, no backoff left from the previous fault */
+    for (unsigned i = 0; i < 4u; ++i)
+        if (dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) != DL_OK)
+            return false;
+    dl_reset_counters();
+
+    t0 = vhal_now_us();
+    vhal_device()->stall_until_us = t0 + stall_ms * 1000u;
+    for (r->calls = 1u; r->calls <= RC_MAX_CALLS; ++r->calls)
+    {
+        if (tiered)
+        {
+            st = dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid);
+        }
+        else
+        {
+            st = dl_read(TEST_ADDR_PRODUCT_ID, 4u, pid, DL_WAIT_AUTO, DL_WAIT_AUTO);
+            if (st != DL_OK)
+                (void)dl_handshake();
+        }
+        if (st == DL_OK)
+            break;
+    }
+    r->ms = ms_since(t0);
+    dl_get_counters(&c);
+    r->retries = c.retries;
+    r->quick   = c.quick_handshakes;
+    r->full    = c.full_handshakes;
+    return st == DL_OK && pid[0] == 0xDEu && pid[1] == 0xC0u;
+}
+
+static bool case_recovery(void)
+{
+    /* the fault lengths that end in each tier: one lost attempt, two, and more than a
+     * whole call plus the quick resyncs in it */
+    static const struct {
+        const char*        tier;
+        dl_recover_level_t level;
+        uint32_t           stall_ms;
+    } k_faults[] = {
+        { "flush", DL_RECOVER_LVL_FLUSH, 15u },
+        { "quick", DL_RECOVER_LVL_QUICK, 60u },
+        { "full",  DL_RECOVER_LVL_FULL,  5000u },
+    };
+
+    CHECK(start(&k_dev), "handshake failed");
+
+    for (size_t k = 0; k < sizeof k_faults / sizeof k_faults[0]; ++k)
+    {
+        rc_result_t tiered = { 0 }, old = { 0 };
+
+        CHECK(rc_run(k_faults[k].stall_ms, true, &tiered), "%s: no recovery within %u calls", k_faults[k].tier, RC_MAX_CALLS);
+        CHECK(rc_run(k_faults[k].stall_ms, false, &old), "%s: full handshakes did not recover", k_faults[k].tier);
+
+        dl_recover_level_t level = (tiered.full != 0u)  ? DL_RECOVER_LVL_FULL
+                                 : (tiered.quick != 0u) ? DL_RECOVER_LVL_QUICK
+                                 : (tiered.retries != 0u) ? DL_RECOVER_LVL_FLUSH : DL_RECOVER_NONE;
+        CHECK(level == k_faults[k].level, "%s: %u ms fault ended after %lu retries, %lu quick, %lu full", k_faults[k].tier,
+              k_faults[k].stall_ms, (unsigned long)tiered.retries, (unsigned long)tiered.quick, (unsigned long)tiered.full);
+        CHECK(tiered.ms < old.ms, "%s: %.1f ms, full handshakes %.1f ms", k_faults[k].tier, tiered.ms, old.ms);
+
+        printf("ok   recovery %-5s: %4u ms fault, recovered after %7.1f ms (%5.1f ms past the fault, %lu retries); "
+               "full handshake each failure %7.1f ms\n", k_faults[k].tier, k_faults[k].stall_ms, tiered.ms,
+               tiered.ms - k_faults[k].stall_ms, (unsigned long)tiered.retries, old.ms);
+    }
+    return true;
+}
+
+/* =============================================================================
+ * handshake - one handshake as it is now (the drain ends once the line is idle) against
+ * the former ending (HAL_Delay(125), then a drain that needed 20 ms of silence, at most
+ * 200 ms), replayed over the default link's transport, for both branches
+ * ===========================================================================*/
+#define HS_ROUNDS              10u
+#define HS_OLD_SETTLE_MS       125u
+#define HS_OLD_QUIET_MS        20u
+#define HS_OLD_DRAIN_MS        200u
+#define HS_STALL_US            30000u   /* reconfiguration stall before the device's own RESET */
+
+static void hs_frame(uint8_t type, uint8_t* f)
+{
+    uint16_t c = crc16_compute((const uint8_t[]){ type, DL_OVERHEAD }, DL_HDR_SIZE, CRC16_INIT);
+
+    f[0] = type;
+    f[1] = DL_OVERHEAD;
+    f[2] = (uint8_t)c;
+    f[3] = (uint8_t)(c >> 8);
+}
+
+static bool hs_expect(uint8_t type, uint32_t wait_ms)
+{
+    const dl_link_t* l = dl_link_default();
+    uint8_t          f[DL_OVERHEAD];
+    uint16_t got = 0u;
+    uint32_t t0  = HAL_GetTick();
+
+    while (got < DL_OVERHEAD && (HAL_GetTick() - t0) < wait_ms)
+        got = (uint16_t)(got + l->tp->recv(l->tp_ctx, &f[got], (uint16_t)(DL_OVERHEAD - got), 1u));
+    return got == DL_OVERHEAD && f[0] == type && f[1] == DL_OVERHEAD && crc16_compute(f, DL_OVERHEAD, CRC16_INIT) == 0u;
+}
+
+/* The former handshake step: either branch, then the fixed settle time and the quiet drain. */
+static bool hs_old(bool device_first)
+{
+    const dl_link_t* l = dl_link_default();
+    uint8_t          f[DL_OVERHEAD];
+    uint32_t         t0, quiet;
+
+    if (device_first)
+    {
+        if (!hs_expect(DL_TYPE_RESET, 100u))
+            return false;
+        hs_frame(DL_TYPE_RESET_RESP, f);
+        (void)l->tp->send(l->tp_ctx, f, DL_OVERHEAD);
+    }
+    else
+    {
+        hs_frame(DL_TYPE_RESET, f);
+        (void)l->tp->send(l->tp_ctx, f, DL_OVERHEAD);
+        if (!hs_expect(DL_TYPE_RESET_RESP, 500u))
+            return false;
+    }
+
+    HAL_Delay(HS_OLD_SETTLE_MS);
+    t0    = HAL_GetTick();
+    quiet = t0;
+    while ((HAL_GetTick() - t0) < HS_OLD_DRAIN_MS)
+    {
+        if (l->tp->recv(l->tp_ctx, f, sizeof f, 0u) != 0u)
+            quiet = HAL_GetTick();
+        else if ((HAL_GetTick() - quiet) >= HS_OLD_QUIET_MS)
+            break;
+    }
+    return true;
+}
+
+/* Mean ms of one handshake over HS_ROUNDS; the device branch first has the device
+ * reconfigure, so it sends its own RESET once the stall ends. */
+static bool hs_measure(bool device_first, bool old, double* mean_ms)
+{
+    uint8_t  pid[4];
+    uint8_t  pw = 32u;
+    uint64_t total = 0u;
+
+    for (unsigned i = 0; i < HS_ROUNDS; ++i)
+    {
+        uint64_t t0;
+        bool     ok;
+
+        if (device_first && dl_write(OCEAN_ADDR_CHANNEL_POWER_SET, 1u, &pw, DL_WAIT_AUTO, DL_WAIT_AUTO) != DL_OK)
+            return false;
+
+        t0 = vhal_now_us();
+        if (old)
+            ok = hs_old(device_first);
+        else
+            ok = device_first ? dl_handshake_quick(1u, 0u, 0u, 0u) : dl_handshake_quick(0u, 1u, 0u, 0u);
+        total += vhal_now_us() - t0;
+
+        if (!ok || dl_read(TEST_ADDR_PRODUCT_ID, 4u, pid, DL_WAIT_AUTO, DL_WAIT_AUTO) != DL_OK)
+            return false;
+    }
+    *mean_ms = (double)total / HS_ROUNDS / 1000.0;
+    return true;
+}
+
+static bool case_handshake(void)
+{
+    ocean_sim_cfg_t cfg = k_dev;
+
+    cfg.stall_us          = HS_STALL_US;
+    cfg.reset_after_stall = true;
+    CHECK(start(&cfg), "handshake failed");
+
+    for (int b = 0; b < 2; ++b)
+    {
+        const char* branch = b ? "device reset" : "host reset";
+        double      now_ms, old_ms;
+
+        CHECK(hs_measure(b != 0, false, &now_ms), "%s: handshake failed", branch);
+        CHECK(hs_measure(b != 0, true, &old_ms), "%s: former handshake failed", branch);
+        CHECK(now_ms + HS_OLD_SETTLE_MS <= old_ms, "%s: %.1f ms, former %.1f ms", branch, now_ms, old_ms);
+        printf("ok   handshake %-12s: %5.1f ms, former fixed settle + quiet drain %5.1f ms (mean of %u)\n", branch,
+               now_ms, old_ms, HS_ROUNDS);
+    }
+    return true;
+}
+
+/* =============================================================================
+ * resync - responses behind line noise (1..OCEAN_SIM_JUNK_MAX random bytes) or with
+ * corrupted bytes, switched on once the link is up (the handshake does not hunt): how
+ * many single attempts still succeed by hunting for the frame, and what the hunt skipped
+ * ===========================================================================*/
+#define RS_READS               200u
+
+static bool case_resync(void)
+{
+    static const struct {
+        const char* name;
+        uint32_t    junk_ppm;           /* of responses */
+        uint32_t    corrupt_ppm;        /* of response bytes */
+        unsigned    min_first_pct;      /* single attempts that must succeed */
+    } k_faults[] = {
+        { "clean",      0u,       0u,    100u },
+        { "noise all",  1000000u, 0u,    100u },     /* the deadline learns the longer responses */
+        { "noise 10%",  100000u,  0u,    95u },      /* a rare long prefix can outrun the deadline */
+        { "corrupt",    0u,       5000u, 90u },      /* ~7% of responses hit; only a retry helps */
+    };
+
+    for (size_t k = 0; k < sizeof k_faults / sizeof k_faults[0]; ++k)
+    {
+        dl_link_counters_t c;
+        uint8_t            pid[4];
+        unsigned           first = 0u, retried = 0u;
+        uint32_t           junk;
+
+        CHECK(start(&k_dev), "%s: handshake failed", k_faults[k].name);
+        vhal_device()->cfg.junk_ppm    = k_faults[k].junk_ppm;
+        vhal_device()->cfg.corrupt_ppm = k_faults[k].corrupt_ppm;
+        junk = vhal_device()->stats.junk;
+
+        for (unsigned i = 0; i < RS_READS; ++i)
+        {
+            memset(pid, 0, sizeof pid);
+            if (dl_read(TEST_ADDR_PRODUCT_ID, 4u, pid, DL_WAIT_AUTO, DL_WAIT_AUTO) == DL_OK)
+            {
+                CHECK(pid[0] == 0xDEu && pid[1] == 0xC0u, "%s: read %u returned wrong data", k_faults[k].name, i);
+                first++;
+            }
+        }
+        dl_get_counters(&c);
+        junk = vhal_device()->stats.junk - junk;
+        for (unsigned i = 0; i < RS_READS; ++i)
+            retried += (dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) == DL_OK);
+
+        CHECK(first * 100u >= k_faults[k].min_first_pct * RS_READS, "%s: %u of %u single attempts succeeded",
+              k_faults[k].name, first, RS_READS);
+        CHECK(retried == RS_READS, "%s: %u of %u reads with retries succeeded", k_faults[k].name, retried, RS_READS);
+        CHECK(c.resync_bytes >= junk, "%s: %lu bytes skipped, %lu noise bytes sent", k_faults[k].name,
+              (unsigned long)c.resync_bytes, (unsigned long)junk);
+
+        printf("ok   resync %-9s: %5.1f%% single attempts ok, %5.1f%% with retries; resync_bytes %4lu "
+               "(%4lu noise bytes), crc_fail %lu, timeouts %lu\n", k_faults[k].name, 100.0 * first / RS_READS,
+               100.0 * retried / RS_READS, (unsigned long)c.resync_bytes, (unsigned long)junk, (unsigned long)c.crc_fail,
+               (unsigned long)(c.hdr_timeouts + c.pay_timeouts));
+    }
+    return true;
+}
+
+/* =============================================================================
+ * overrun - a receive overrun (vhal_inject_overrun) drops a byte in the middle of a
+ * response: the attempt must fail as soon as the USART reports it, not at the deadline,
+ * be counted and traced, and a retry right behind it must succeed despite the tail of the
+ * damaged response still arriving
+ * ===========================================================================*/
+#define OR_LOST_BYTE           5u       /* a data byte of the 4-byte READ response */
+
+static uint8_t  s_or_dump[DL_TRACE_HDR_SIZE + DL_TRACE_ENTRIES * sizeof(dl_trace_entry_t)];
+static uint16_t s_or_dumped;
+
+static void or_sink(const uint8_t* p, uint16_t n, void* ctx)
+{
+    (void)ctx;
+    if (s_or_dumped + n <= sizeof s_or_dump)
+        memcpy(&s_or_dump[s_or_dumped], p, n);
+    s_or_dumped = (uint16_t)(s_or_dumped + n);
+}
+
+/* Flags of every traced frame OR'ed together. */
+static uint8_t or_trace_flags(void)
+{
+    uint8_t  flags = 0u;
+    uint16_t count;
+
+    s_or_dumped = 0u;
+    dl_trace_dump((uint32_t)vhal_now_us(), or_sink, NULL);
+    count = (uint16_t)(s_or_dump[8] | (s_or_dump[9] << 8));
+    for (uint16_t i = 0; i < count; ++i)
+    {
+        dl_trace_entry_t e;
+        memcpy(&e, &s_or_dump[DL_TRACE_HDR_SIZE + i * sizeof e], sizeof e);
+        flags |= e.flags;
+    }
+    return flags;
+}
+
+static bool case_overrun(void)
+{
+    dl_link_counters_t c;
+    dl_status_t        st;
+    uint8_t            pid[4];
+    uint64_t           t0;
+    double             clean_ms, fail_ms, retry_ms;
+
+    CHECK(start(&k_dev), "handshake failed");
+    for (unsigned i = 0; i < 10u; ++i)
+        CHECK(dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) == DL_OK, "warm-up read %u failed", i);
+
+    t0 = vhal_now_us();
+    CHECK(dl_read(TEST_ADDR_PRODUCT_ID, 4u, pid, DL_WAIT_AUTO, DL_WAIT_AUTO) == DL_OK, "clean read failed");
+    clean_ms = ms_since(t0);
+
+    dl_reset_counters();
+    dl_trace_clear();
+    vhal_inject_overrun(OR_LOST_BYTE);
+    t0 = vhal_now_us();
+    st = dl_read(TEST_ADDR_PRODUCT_ID, 4u, pid, DL_WAIT_AUTO, DL_WAIT_AUTO);
+    fail_ms = ms_since(t0);
+    dl_get_counters(&c);
+
+    CHECK(st == DL_ERR_INVALID_RESPONSE, "read with a lost byte returned %d", (int)st);
+    CHECK(fail_ms < clean_ms, "failed after %.1f ms, a whole response takes %.1f ms", fail_ms, clean_ms);
+    CHECK(c.overruns == 1u, "%lu overruns counted", (unsigned long)c.overruns);
+    CHECK(c.hdr_timeouts + c.pay_timeouts == 0u, "the attempt ran into its deadline");
+    CHECK(or_trace_flags() & DL_TRACE_OVERRUN, "no overrun in the trace");
+
+    memset(pid, 0, sizeof pid);
+    t0 = vhal_now_us();
+    CHECK(dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) == DL_OK, "read after the overrun failed");
+    retry_ms = ms_since(t0);
+    CHECK(pid[0] == 0xDEu && pid[1] == 0xC0u, "read after the overrun returned wrong data");
+    dl_get_counters(&c);
+    CHECK(c.overruns == 1u, "%lu overruns counted after the retry", (unsigned long)c.overruns);
+
+    printf("ok   overrun: byte %u of the response lost, attempt failed after %.1f ms (clean read %.1f ms), "
+           "next read ok in %.1f ms (%lu retries)\n", OR_LOST_BYTE, fail_ms, clean_ms, retry_ms,
+           (unsigned long)c.retries);
+    return true;
+}
+
+/* =============================================================================
+ * restart - reception restarted (HAL_UART_ErrorCallback) after the ring had dropped bytes:
+ * the loss count the transport reports must not go down, or the read in flight would be
+ * failed for an overrun that never happened
+ * ===========================================================================*/
+#define RST_DROPPED            3u       /* ring drops from before the read */
+
+static void rst_done(dl_status_t st, void* ctx)
+{
+    *(dl_status_t*)ctx = st;
+}
+
+static bool case_restart(void)
+{
+    dl_hal_port_t*     port;
+    dl_link_counters_t c;
+    dl_status_t        st = DL_ERR_BUSY;
+    uint8_t            pid[4];
+
+    CHECK(start(&k_dev), "handshake failed");
+    port = (dl_hal_port_t*)dl_link_default()->tp_ctx;
+    port->rx.dropped = RST_DROPPED;
+    CHECK(dl_read_retry(TEST_ADDR_PRODUCT_ID, 4u, pid) == DL_OK, "read before the restart failed");
+    dl_reset_counters();
+
+    memset(pid, 0, sizeof pid);
+    CHECK(dl_read_async(TEST_ADDR_PRODUCT_ID, 4u, pid, rst_done, &st) == DL_OK, "submit failed");
+    (void)dl_poll();                      /* the request goes out */
+    HAL_UART_ErrorCallback(&huart1);
+    while (dl_poll())
+        ;
+    dl_get_counters(&c);
+
+    CHECK(st == DL_OK, "read across the restart returned %d", (int)st);
+    CHECK(pid[0] == 0xDEu && pid[1] == 0xC0u, "read across the restart returned wrong data");
+    CHECK(c.overruns == 0u, "%lu overruns counted", (unsigned long)c.overruns);
+
+    printf("ok   restart: %u earlier ring drops kept across a reception restart, read in flight ok\n", RST_DROPPED);
+    return true;
+}
+
+/* =============================================================================
+ * Runner
+ * ===========================================================================*/
+static const struct {
+    const char* name;
+    bool      (*run)(void);
+} k_cases[] = {
+    { "interleave", case_interleave },
+    { "rtt_rise",   case_rtt_rise },
+    { "recovery",   case_recovery },
+    { "handshake",  case_handshake },
+    { "resync",     case_resync },
+    { "overrun",    case_overrun },
+    { "restart",    case_restart },
+};
+
+static bool run_case(size_t k)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        bool ok = k_cases[k].run();
+        fflush(stdout);
+        _exit(ok ? 0 : 1);
+    }
+    if (pid < 0 || waitpid(pid, &status, 0) < 0)
+    {
+        perror("fork");
+        exit(1);
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned failed = 0u;
+    unsigned ran    = 0u;
+
+    for (size_t k = 0; k < sizeof k_cases / sizeof k_cases[0]; ++k)
+    {
+        bool wanted = (argc < 2);
+
+        for (int i = 1; i < argc; ++i)
+            wanted = wanted || (strcmp(argv[i], k_cases[k].name) == 0);
+        if (!wanted)
+            continue;
+
+        ran++;
+        if (!run_case(k))
+        {
+            printf("FAIL %s\n", k_cases[k].name);
+            failed++;
+        }
+    }
+
+    if (ran == 0u)
+    {
+        fprintf(stderr, "no such case\n");
+        return 2;
+    }
+    printf("%s: %u of %u cases passed\n", failed ? "FAILED" : "PASSED", ran - failed, ran);
+    return failed ? 1 : 0;
+}